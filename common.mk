@@ -34,11 +34,17 @@ OUTNAME=output.elf
 # Flags for programs
 AFLAGS:=$(MCUAFLAGS)
 ARFLAGS:=$(MCUCFLAGS)
+# Add -DFIXED_POINT_CONTROL to use fixed-point controllers internally (see include/controlTypes.h)
+# Add -DFAST_MATH to use approximate trig and square root in odometry and path following (see include/coreIncludes.h)
+# Add -DDOUBLE_PRECISION to use doubles instead of floats in controllers and drives (see include/coreIncludes.h)
+# Add -DPROFILING to time control subsystems each cycle (see include/profiler.h)
+# Add -DTELEMETRY_LEVEL=<1-3> to stream binary records of control state over the serial port (see include/telemetry.h)
 CCFLAGS:=-c -Wall $(MCUCFLAGS) -Os -ffunction-sections -fsigned-char -fomit-frame-pointer -fsingle-precision-constant
 CFLAGS:=$(CCFLAGS) -std=gnu99 -Werror=implicit-function-declaration
 #CPPFLAGS:=$(CCFLAGS) -std=c++0x -Werror=implicit-function-declaration
 CPPFLAGS:=$(CCFLAGS) -fno-exceptions -fno-rtti -felide-constructors
-LDFLAGS:=-Wall $(MCUCFLAGS) $(MCULFLAGS) -Wl,--gc-sections
+# --wrap=malloc lets HeapGuard report allocations made after startup (see include/heapGuard.h)
+LDFLAGS:=-Wall $(MCUCFLAGS) $(MCULFLAGS) -Wl,--gc-sections -Wl,--wrap=malloc
 
 # Tools used in program
 AR:=$(MCUPREFIX)ar
@@ -46,3 +52,19 @@ AS:=$(MCUPREFIX)as
 CC:=$(MCUPREFIX)gcc
 CPPCC:=$(MCUPREFIX)g++
 OBJCOPY:=$(MCUPREFIX)objcopy
+
+# Host-side simulation build (make sim)
+SIMDIR=$(ROOT)/sim
+SIMBINDIR=$(BINDIR)/sim
+SIMOUTNAME=simulator
+SIMCC:=g++
+SIMFLAGS:=-c -Wall -O2 -fsigned-char -fno-exceptions -fno-rtti -std=c++14 -DSIMULATION
+SIMLDFLAGS:=-lm
+# Offline trajectory generation (paths/*.path -> include/trajectories/*.h)
+PATHDIR=$(ROOT)/paths
+TRAJDIR=$(ROOT)/include/trajectories
+TRAJGEN=$(BINDIR)/tools/trajectoryGenerator
+# Telemetry decoding (make decoder)
+TELEMDEC=$(BINDIR)/tools/telemetryDecoder
+# Object size report (make footprint)
+FOOTPRINT=$(BINDIR)/tools/footprint
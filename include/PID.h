@@ -1,45 +1,66 @@
 /* A general PID controller with adjustable coefficients, target value,
-	sample time and integral restrictions */
+	sample time and integral restrictions
+
+	Optional features, each of which costs nothing unless enabled:
+		- output limits, with conditional integration or back-calculation
+			anti-windup (a comparison or a multiplication per evaluation)
+		- derivative on measurement, which avoids the derivative kick of target
+			changes (no extra cost)
+		- a first-order low-pass filter on the derivative term (one
+			multiplication per evaluation)
+	The first evaluation after reset() has no derivative term. */
 
 #ifndef PID_INCLUDED
 #define PID_INCLUDED
 
 #include "ramper.h"
-
-class Timer;
+#include "timer.h"
 
 class PID : public Ramper {
 	public:
-		double evaluate(double input);		//performs PID calculations
+		real_t evaluate(real_t input);		//performs PID calculations
 		void reset();       					 		//sets integral and prev-error to zero and resets updateTimer
-		void changeTarget(double target);	//sets target and calls reset()
-    PID(double target, double kP, double kI, double kD, unsigned short minSampleTime=30, double integralMax=0, bool useTimeAdjustment=false);
+		void changeTarget(real_t target);	//sets target and calls reset()
+    PID(real_t target, real_t kP, real_t kI, real_t kD, unsigned short minSampleTime=30, real_t integralMax=0, bool useTimeAdjustment=false);
 		//accessors and mutators
-		double get_kP();
-    double get_kI();
-    double get_kD();
-		void setCoeffs(double kP, double kI, double kD);
-		double getTarget();
-		double getIntegral();
-		void setIntegral(double integral);
+		real_t get_kP();
+    real_t get_kI();
+    real_t get_kD();
+		void setCoeffs(real_t kP, real_t kI, real_t kD);
+		real_t getTarget();
+		real_t getIntegral();
+		void setIntegral(real_t integral);
 		unsigned short getMinSampleTime();
 		void setMinSampleTime(unsigned short time);
-		double getIntegralMin();
-		void setIntegralMin(double min);
-		double getIntegralMax();
-		void setIntegralMax(double max);
+		real_t getIntegralMin();
+		void setIntegralMin(real_t min);
+		real_t getIntegralMax();
+		void setIntegralMax(real_t max);
+		//robustness options
+		void setOutputLimits(real_t min, real_t max);	//limits are inactive if min == max (the default)
+		void setAntiWindup(antiWindupType type, real_t trackingGain=0.5);	//trackingGain is only used by BACK_CALCULATION
+		void setDerivativeOnMeasurement(bool onMeasurement);
+		void setDerivativeFilter(real_t weight);	//weight of newest derivative in filtered value (1 disables filter)
 
 	private:
-		Timer* updateTimer; //stores time since last evaluation
-		double integral;		//integral of error value
-		double prevError;   //error value at last evaluation
-		double prevOutput;	//output at last evaluation
+		TickTimer updateTimer;	//stores time since last evaluation
+		real_t integral;		//integral of error value (kI factored in)
+		real_t prevError;   //error value at last evaluation
+		real_t prevInput;		//input at last evaluation
+		real_t prevDerivative;	//(filtered) derivative term at last evaluation
+		real_t prevOutput;	//output at last evaluation
+		bool firstSample;		//whether no evaluation has occurred since reset()
 		//configuration (user set)
-		double target;
-		double kP, kI, kD;						//tuning coefficients
+		real_t target;
+		real_t kP, kI, kD;						//tuning coefficients
 		unsigned short minSampleTime;	//minimum time (milliseconds) before accepting new input
-		double integralMax; 					//Maximum absolute error value which will be added to the integral (inactive if 0)
+		real_t integralMax; 					//Maximum absolute error value which will be added to the integral (inactive if 0)
 		bool useTimeAdjustment;				//whether to adjust integral and derivative calculation by time interval between evaluations
+		real_t outputMin, outputMax;
+		antiWindupType antiWindup;
+		real_t trackingGain;
+		bool derivativeOnMeasurement;
+		real_t derivativeWeight;
 };
 
 #endif
@@ -0,0 +1,72 @@
+/* Holds several PID controllers in contiguous arrays and updates them all in
+  one pass with a shared time step
+
+  Each controller's gains, target, integral and previous error live in
+  parallel arrays (indexed by the id returned by add()), so update() is a
+  single tight loop with no virtual calls, per-controller timers or sample
+  time checks. Controllers may register an input function, which update()
+  calls to read the controlled value before the pass, and an output function,
+  which it calls with the result afterwards; otherwise, use setInput() and
+  getOutput(). Outputs are limited to [outputMin, outputMax] with conditional
+  integration anti-windup (see antiWindupType), and the first update after
+  setTarget() or reset() has no derivative term.
+
+  Gains are per update period: runInBackground() scales each update's
+  integral and derivative by the measured interval divided by the period, so
+  late updates are accounted for. MotorGroups join the bank with
+  MotorGroup::posPIDinitInBank(). */
+
+#ifndef PID_BANK_INCLUDED
+#define PID_BANK_INCLUDED
+
+#include "coreIncludes.h" //for real_t
+#include "timer.h"
+#include <stddef.h>
+
+#define MAX_BANK_CONTROLLERS 8
+
+typedef real_t (*PIDInput)(void *object);
+typedef void (*PIDOutput)(void *object, real_t output);
+
+class PIDBank {
+  public:
+    static char add(real_t kP, real_t kI, real_t kD, real_t integralMax=0, real_t outputMin=-127, real_t outputMax=127, PIDInput input=NULL, PIDOutput output=NULL, void *object=NULL);
+    /* Registers a controller (inactive until setTarget() is called). Returns
+      its id, or -1 if MAX_BANK_CONTROLLERS controllers are already
+      registered. */
+    static void remove(char id);
+    static void update(real_t timeStep=1);  //updates every active controller. timeStep is the time since the last update in update periods
+    static void runInBackground(unsigned short period=10);  //registers a Scheduler job which calls update() every period milliseconds
+    static unsigned short getPeriod();                      //milliseconds
+    //controllers
+    static void setTarget(char id, real_t target);  //sets target, resets and activates controller
+    static real_t getTarget(char id);
+    static void setActive(char id, bool active);    //inactive controllers are skipped by update()
+    static bool isActive(char id);
+    static void reset(char id);                     //sets integral and previous error to zero
+    static void setInput(char id, real_t input);    //for controllers without an input function
+    static real_t getInput(char id);
+    static real_t getOutput(char id);
+    static void setCoeffs(char id, real_t kP, real_t kI, real_t kD);
+    static void setOutputLimits(char id, real_t min, real_t max);
+  private:
+    static bool valid(char id);
+    static void backgroundJob(void *ignore);
+    //controller state, indexed by id
+    static real_t kP[MAX_BANK_CONTROLLERS], kI[MAX_BANK_CONTROLLERS], kD[MAX_BANK_CONTROLLERS];
+    static real_t integralMax[MAX_BANK_CONTROLLERS];  //maximum absolute error added to integral (inactive if 0)
+    static real_t outputMin[MAX_BANK_CONTROLLERS], outputMax[MAX_BANK_CONTROLLERS];
+    static real_t target[MAX_BANK_CONTROLLERS], input[MAX_BANK_CONTROLLERS], output[MAX_BANK_CONTROLLERS];
+    static real_t integral[MAX_BANK_CONTROLLERS], prevError[MAX_BANK_CONTROLLERS];
+    static PIDInput inputs[MAX_BANK_CONTROLLERS];
+    static PIDOutput outputs[MAX_BANK_CONTROLLERS];
+    static void *objects[MAX_BANK_CONTROLLERS];
+    static unsigned char usedMask, activeMask, freshMask;  //bit id set if controller is registered/active/has not been updated since reset
+    static unsigned char count;                           //one more than highest registered id
+    //background execution
+    static unsigned short period;
+    static TickTimer updateTimer;
+    static bool scheduled;
+};
+
+#endif
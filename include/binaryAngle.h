@@ -0,0 +1,41 @@
+/* Binary angles (BAM) for headings which wrap around
+
+  A bam is a 32-bit unsigned integer in which a full turn is 2^32, so adding and
+  subtracting angles wraps around for free and (int32_t)(a - b) is always the
+  shortest signed difference between two headings. The top 16 bits form a
+  16-bit BAM, and the top bits index the sine table directly, so neither needs
+  any arithmetic beyond a shift. Conversions to and from doubles still go
+  through software floating point and are best kept out of tight loops. */
+
+#ifndef BINARY_ANGLE_INCLUDED
+#define BINARY_ANGLE_INCLUDED
+
+#include "coreIncludes.h" //also includes cmath
+#include <stdint.h>
+
+typedef uint32_t bam;
+
+const bam BAM_QUARTER_TURN = 0x40000000;
+const bam BAM_HALF_TURN = 0x80000000;
+
+inline bam toBam(double angle, angleType format=DEGREES) {
+  return (int64_t)(angle * (format==DEGREES ? 4294967296.0/360 : 4294967296.0/(2*PI)));
+}
+
+inline double fromBam(bam angle, angleType format=DEGREES) { //returns an angle in [-180, 180) degrees or [-pi, pi) radians
+  return (int32_t)angle * (format==DEGREES ? 360/4294967296.0 : 2*PI/4294967296.0);
+}
+
+inline bam degreesToBam(int degrees) { //exact (rounded down) using only integer arithmetic
+  int turnDegrees = degrees % 360;
+  if (turnDegrees < 0) turnDegrees += 360;
+  return turnDegrees*11930464u + (turnDegrees*256u)/360; //2^32/360 = 11930464 + 256/360
+}
+
+inline int32_t bamDifference(bam a, bam b) { return a - b; } //shortest signed angle from b to a
+
+float bamSin(bam angle);
+/* Table lookup with linear interpolation. Max absolute error 1.9e-5. */
+float bamCos(bam angle);  //bamSin(angle + BAM_QUARTER_TURN)
+
+#endif
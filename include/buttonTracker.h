@@ -1,5 +1,11 @@
 /* Allows for tracking of button state for toggle-type control and
-  checks validity of button combinations */
+  checks validity of button combinations
+
+  Every button of every joystick is polled once per update() and packed into
+  a bitmask (4 bits per button group, in the order of the JOY_* values, and
+  16 bits per joystick), so queries are bit operations on the current and
+  previous masks. update() is called by SensorCache::update(), or can be
+  called directly once at the start of every control loop iteration. */
 
 #ifndef BUTTON_TRACKER_INCLUDED
 #define BUTTON_TRACKER_INCLUDED
@@ -8,16 +14,34 @@
 
 class ButtonTracker {
   public:
+    static void update();
+    /* Polls every button and updates the masks. Until this is first called,
+      isPressed() reads buttons directly and the other queries return false
+      or 0. */
+    static void update(unsigned long mask); //updates using mask instead of polling (used by InputRecorder playback)
+    static bool isPressed(unsigned char buttonGroup, unsigned char button, unsigned char joystick=1);
     static bool newlyPressed(unsigned char buttonGroup, unsigned char button, unsigned char joystick=1);
-    /* Returns true if button has been pressed since last call (but was not pressed previously) */
+    /* Returns true if button was pressed at last update but not at the update before */
+    static bool released(unsigned char buttonGroup, unsigned char button, unsigned char joystick=1);
+    /* Returns true if button was pressed at the update before last but not at last update */
+    static unsigned long heldDuration(unsigned char buttonGroup, unsigned char button, unsigned char joystick=1);
+    /* Returns the number of milliseconds for which button has been pressed (0 if it is not pressed) */
     static bool isValidButton(unsigned char buttonGroup, unsigned char button, unsigned char joystick=1);
     /* Returns true if joystick, buttonGroup, and button form a valid button identifier
 
       Checks that joystick <= NUM_JOYSTICKS (defined in config.h) and that buttonGroup
       and button correspond to a real button (i.e. allows 5U and 7R but not 9U or 6R) */
+    //masks
+    static unsigned long buttonBit(unsigned char buttonGroup, unsigned char button, unsigned char joystick=1) {
+      return (unsigned long)button << (4*(buttonGroup-5) + 16*(joystick-1));
+    }
+    static unsigned long pressedMask();       //buttons pressed at last update
+    static unsigned long newlyPressedMask();
+    static unsigned long releasedMask();
   private:
-    static bool pressedButtons[][4][4];
-    /* Holds the states of the buttons at last update */
+    static unsigned long current, previous; //masks of pressed buttons at last two updates
+    static unsigned long pressTimes[32];    //millis() at which each button was last pressed, indexed by bit
+    static bool polled;                     //whether update() has been called
 };
 
 #endif
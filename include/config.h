@@ -7,7 +7,6 @@
 
 //#region defaults
 #define NUM_JOYSTICKS 1
-#define DEBUG_LEVEL 0 //0 is not debugging, higher levels yield increasingly detailed output (currently non-functional)
 //#endregion
 
 
@@ -16,30 +15,38 @@
   //#subregion includes
   #include "parallelDrive.h"
   #include "buttonGroup.h"
+  #include "motorPorts.h"
   //#endsubregion
   //#subregion motors
-  //initializer lists of motor ports (mps = motor ports)
   //drive
-  #define LD_MPS  { 1 }   //left
-  #define RD_MPS  { 2 }  //right
+  typedef MotorPorts<1> LeftDrivePorts;
+  typedef MotorPorts<2> RightDrivePorts;
   //flapper
-  #define FLAPPER_MPS  { 3 }
+  typedef MotorPorts<3> FlapperPorts;
+
+  static_assert(distinctMotorPorts<LeftDrivePorts, RightDrivePorts, FlapperPorts>(), "motor port used by more than one group");
   //#endsubregion
   //#subregion sensors
   //flapper
-  #define FLAPPER_POT  1
+  constexpr unsigned char FLAPPER_POT = 1;
   //drive
-  #define HYRO        5
-  #define RIGHT_ENC   4, 3, false
-  #define LEFT_ENC    2, 1, false
+  constexpr unsigned char HYRO = 5;
+  constexpr unsigned char LEFT_ENC_TOP = 2, LEFT_ENC_BOTTOM = 1;
+  constexpr unsigned char RIGHT_ENC_TOP = 4, RIGHT_ENC_BOTTOM = 3;
+  constexpr bool LEFT_ENC_REVERSED = false, RIGHT_ENC_REVERSED = false;
+
+  static_assert(distinctPorts<FLAPPER_POT, HYRO>(), "analog port used by more than one sensor");
+  static_assert(distinctPorts<LEFT_ENC_TOP, LEFT_ENC_BOTTOM, RIGHT_ENC_TOP, RIGHT_ENC_BOTTOM>(), "digital port used by more than one sensor");
   //#endsubregion
   //#subregion buttons
   //flapper
-  #define FLAPPER_GROUP 6
+  constexpr unsigned char FLAPPER_GROUP = 6;
   //#endsubregion
   //#subregion constants
-  #define WHEEL_DIAMETER 4.0
+  constexpr real_t WHEEL_DIAMETER = 4.0;
+  constexpr DriveWheel DRIVE_WHEEL(WHEEL_DIAMETER);
   //#endsubregion
+
   //#region global externs
   extern ParallelDrive drive;
   extern ButtonGroup flapper;
@@ -0,0 +1,23 @@
+/* Selects the controller implementations used internally by the library
+  (MotorGroup position targeting and ParallelDrive maneuvers)
+
+  Define FIXED_POINT_CONTROL (e.g. by adding -DFIXED_POINT_CONTROL to CCFLAGS
+  in common.mk) to use the fixed-point versions, which avoid software floating
+  point in control loops. Either version can still be used directly. */
+
+#ifndef CONTROL_TYPES_INCLUDED
+#define CONTROL_TYPES_INCLUDED
+
+#ifdef FIXED_POINT_CONTROL
+  #include "fixedPID.h"
+  #include "fixedQuadRamp.h"
+  typedef FixedPID ControlPID;
+  typedef FixedQuadRamp ControlQuadRamp;
+#else
+  #include "PID.h"
+  #include "quadRamp.h"
+  typedef PID ControlPID;
+  typedef QuadRamp ControlQuadRamp;
+#endif
+
+#endif
@@ -5,12 +5,31 @@
 
 #include <cmath>
 
-const double PI = acos(-1);
+constexpr double PI = 3.14159265358979323846;
 /* Because cmath doesn't have a pi constant for some reason */
 
+#ifdef DOUBLE_PRECISION
+  typedef double real_t;
+#else
+  typedef float real_t;
+#endif
+/* Floating point type used for the state and arithmetic of controllers, motor
+  groups and drives. The Cortex has no floating point unit, so every operation
+  is emulated in software, and double operations cost about twice as much as
+  float ones (and twice the RAM). Define DOUBLE_PRECISION (e.g. by adding
+  -DDOUBLE_PRECISION to CCFLAGS in common.mk) to use doubles instead. */
+
 enum angleType { DEGREES, RADIANS };
 /*Used for specifying the format of an angle. */
 
+enum antiWindupType { NO_ANTI_WINDUP, CONDITIONAL_INTEGRATION, BACK_CALCULATION };
+/* Used for specifying how a PID controller with output limits keeps its
+  integral from growing while the output is saturated. Conditional
+  integration stops integrating while the error would drive the output further
+  past its limit. Back-calculation integrates normally but then bleeds off a
+  fraction (the tracking gain) of the amount by which the output exceeds its
+  limit. */
+
 int limit(int input, int min, int max);
 /* Restricts input to the interval [min, max]
 
@@ -22,7 +41,45 @@ int limit(int input, int min, int max);
 double convertAngle(double angle, angleType input, angleType output);
 /* Converts angle of type input to type output */
 
+constexpr real_t encoderCoefficient(real_t wheelDiameter, real_t gearRatio=1) {
+  return PI * wheelDiameter * gearRatio / 360;
+}
+/* Inches per tick of a 360 tick/revolution encoder on a wheel of the specified
+  diameter (gearRatio is wheel revolutions per encoder revolution). Folded at
+  compile time when its arguments are constants. */
+
 char sgn(double x);
 /* The signum function. Returns -1 for x<0, 0 for x=0, and 1 for x>0. */
 
+//#region fast math
+/* Single-precision approximations which avoid the (software floating point)
+  libm routines on the Cortex. Maximum errors were measured on the host over
+  the stated ranges against double-precision libm. */
+float fastSin(float x);
+/* Max absolute error 7.4e-7 for |x| <= 100 radians (range reduction loses
+  accuracy beyond that) */
+float fastCos(float x);             //same error as fastSin()
+float fastAtan2(float y, float x);
+/* Max absolute error 1.2e-5 radians. Returns 0 for (0, 0). */
+float fastSqrt(float x);
+/* Max relative error 4.8e-6. Returns 0 for x <= 0. */
+float fastHypot(float x, float y);  //fastSqrt(x*x + y*y)
+
+/* Path following and HolonomicDrive::setDrivePowerByAngle() call the
+  functions below (odometry and drive correction use bamSin() and bamCos()
+  from binaryAngle.h instead). Define FAST_MATH (e.g. by adding -DFAST_MATH
+  to CCFLAGS in common.mk) to route them through the approximations above. */
+#ifdef FAST_MATH
+  inline float controlSin(float x) { return fastSin(x); }
+  inline float controlCos(float x) { return fastCos(x); }
+  inline float controlSqrt(float x) { return fastSqrt(x); }
+  inline float controlHypot(float x, float y) { return fastHypot(x, y); }
+#else
+  inline double controlSin(double x) { return sin(x); }
+  inline double controlCos(double x) { return cos(x); }
+  inline double controlSqrt(double x) { return sqrt(x); }
+  inline double controlHypot(double x, double y) { return hypot(x, y); }
+#endif
+//#endregion
+
 #endif
@@ -0,0 +1,63 @@
+/* Fixed-point (Q16.16) version of PID with the same interface
+
+  Avoids software floating point in its calculations (entirely so when
+  evaluateFixed() is used), which makes it several times cheaper on the
+  Cortex. Coefficients are quantized to 1/65536 and values are
+  limited to +/-32768, so very small gains (e.g. kI < 0.01) lose some relative
+  precision and inputs should stay within that range. The optional output
+  limits, anti-windup and derivative settings behave as in PID. */
+
+#ifndef FIXED_PID_INCLUDED
+#define FIXED_PID_INCLUDED
+
+#include "ramper.h"
+#include "fixedPoint.h"
+#include "timer.h"
+
+class FixedPID : public Ramper {
+  public:
+    real_t evaluate(real_t input);    //performs PID calculations
+    fixed evaluateFixed(fixed input); //same as above, without any floating point conversions
+    void reset();                     //sets integral and prev-error to zero and resets updateTimer
+    void changeTarget(real_t target); //sets target and calls reset()
+    FixedPID(real_t target, real_t kP, real_t kI, real_t kD, unsigned short minSampleTime=30, real_t integralMax=0, bool useTimeAdjustment=false);
+    //accessors and mutators
+    real_t get_kP();
+    real_t get_kI();
+    real_t get_kD();
+    void setCoeffs(real_t kP, real_t kI, real_t kD);
+    real_t getTarget();
+    real_t getIntegral();
+    void setIntegral(real_t integral);
+    unsigned short getMinSampleTime();
+    void setMinSampleTime(unsigned short time);
+    real_t getIntegralMax();
+    void setIntegralMax(real_t max);
+    //robustness options (see PID)
+    void setOutputLimits(real_t min, real_t max);
+    void setAntiWindup(antiWindupType type, real_t trackingGain=0.5);
+    void setDerivativeOnMeasurement(bool onMeasurement);
+    void setDerivativeFilter(real_t weight);
+
+  private:
+    TickTimer updateTimer;  //stores time since last evaluation
+    fixed integral;     //integral of error value
+    fixed prevError;    //error value at last evaluation
+    fixed prevInput;    //input at last evaluation
+    fixed prevDerivative; //(filtered) derivative term at last evaluation
+    fixed prevOutput;   //output at last evaluation
+    bool firstSample;   //whether no evaluation has occurred since reset()
+    //configuration (user set)
+    fixed target;
+    fixed kP, kI, kD;             //tuning coefficients
+    unsigned short minSampleTime; //minimum time (milliseconds) before accepting new input
+    fixed integralMax;            //Maximum absolute error value which will be added to the integral (inactive if 0)
+    bool useTimeAdjustment;       //whether to adjust integral and derivative calculation by time interval between evaluations
+    fixed outputMin, outputMax;
+    antiWindupType antiWindup;
+    fixed trackingGain;
+    bool derivativeOnMeasurement;
+    fixed derivativeWeight;
+};
+
+#endif
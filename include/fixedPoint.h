@@ -0,0 +1,48 @@
+/* Q16.16 fixed-point numbers for use in control loops
+
+  The Cortex has no floating point unit, so every double operation is emulated
+  in software. fixed values are 32-bit integers holding value * 65536, giving a
+  range of about +/-32768 with a resolution of 1/65536. Conversions to and from
+  double still go through software floating point, so they are best kept out
+  of tight loops. */
+
+#ifndef FIXED_POINT_INCLUDED
+#define FIXED_POINT_INCLUDED
+
+#include <stdint.h>
+
+typedef int32_t fixed;
+
+const fixed FIXED_ONE = 1 << 16;
+const fixed FIXED_MAX = INT32_MAX;
+const fixed FIXED_MIN = -INT32_MAX;
+
+inline fixed toFixed(double x) {
+  //saturates instead of overflowing
+  if (x >= 32767.99998) return FIXED_MAX;
+  if (x <= -32767.99998) return FIXED_MIN;
+  return x * FIXED_ONE + (x < 0 ? -0.5 : 0.5);
+}
+
+inline fixed toFixed(int x) { return x << 16; }
+
+inline double fromFixed(fixed x) { return x / 65536.0; }
+
+inline fixed saturate(int64_t x) {
+  return x > FIXED_MAX ? FIXED_MAX : (x < FIXED_MIN ? FIXED_MIN : x);
+}
+
+inline fixed fixedMul(fixed a, fixed b) {
+  return saturate(((int64_t)a * b) >> 16);
+}
+
+inline fixed fixedDiv(fixed a, fixed b) {
+  if (b == 0) return a<0 ? FIXED_MIN : FIXED_MAX;
+  return saturate(((int64_t)a << 16) / b);
+}
+
+fixed fixedExp(fixed x);
+/* e^x, saturating at FIXED_MAX for x > ~10.4. Error is within 0.002% or 1/65536,
+  whichever is larger. */
+
+#endif
@@ -0,0 +1,21 @@
+/* Fixed-point (Q16.16) version of SigRamp with the same interface
+
+  Constants are calculated in floating point on construction, after which
+  evaluation uses only integer math (see fixedExp() in fixedPoint.h). */
+
+#ifndef FIXED_SIG_RAMP_INCLUDED
+#define FIXED_SIG_RAMP_INCLUDED
+
+#include "ramper.h"
+#include "fixedPoint.h"
+
+class FixedSigRamp : public Ramper {
+  public:
+    real_t evaluate(real_t input);
+    fixed evaluateFixed(fixed input); //same as above, without any floating point conversions
+    FixedSigRamp(real_t k=0.0005, real_t M=127, real_t intercept=10);
+  private:
+    fixed kM2, M2, C, s;  //tuning constants in logistic equation (kM2 = k*M2)
+};
+
+#endif
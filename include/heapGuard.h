@@ -0,0 +1,32 @@
+/* Detects heap allocations made after startup
+
+  Library objects hold everything by value, so once they are constructed the
+  library never allocates. Calling lock() at the end of initialize() turns any
+  later allocation (from user code, a task created after startup, etc.) into a
+  printed error, so code meant to run for a whole match can be checked for
+  heap use. On the Cortex, malloc() is wrapped at link time (-Wl,--wrap=malloc
+  in common.mk), which also covers new. In the simulator, the replacement new
+  operator in sim/simHeap.cpp reports to allocated() instead, and the
+  simulator exits with an error status if any violations occurred. */
+
+#ifndef HEAP_GUARD_INCLUDED
+#define HEAP_GUARD_INCLUDED
+
+#include <stddef.h>
+
+class HeapGuard {
+  public:
+    static void lock();
+    static void unlock(); //e.g. around a deliberate allocation such as creating a task
+    static bool isLocked();
+    static unsigned int violations(); //number of allocations made while locked
+    static void allocated(size_t size);
+    /* Called for every allocation. Prints an error and counts the allocation
+      if the guard is locked. */
+  private:
+    static bool locked;
+    static bool reporting;  //prevents recursion if printing allocates
+    static unsigned int violationCount;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/* General class for modeling a four-wheeled holonomic (X or mecanum) drive
+
+  Each wheel is modeled by a MotorGroup. Supports taking user input (optionally
+  field-centric, using a gyroscope) and setting powers by vector or angle.
+  Wheel powers are scaled down together so that no wheel saturates and the
+  direction of motion is preserved. */
+
+#ifndef HOLONOMIC_DRIVE_INCLUDED
+#define HOLONOMIC_DRIVE_INCLUDED
+
+#include "coreIncludes.h" //also includes cmath
+#include "binaryAngle.h"
+#include "responseCurve.h"
+#include "motorGroup.h"
+#include <API.h>
+
+enum wheelPosition { LEFT_FRONT, RIGHT_FRONT, LEFT_BACK, RIGHT_BACK };
+
+class HolonomicDrive {
+  public:
+    //#region main methods
+    void takeInput();
+    void setDrivePower(char leftFront, char rightFront, char leftBack, char rightBack);
+    void setDrivePowerByVector(real_t x, real_t y, real_t turn=0, bool fieldRelative=false);
+    /* Drives along <x, y> (x to the right, y forward) while turning with power
+        turn (positive is clockwise). If fieldRelative is true, <x, y> is
+        relative to the gyro's zero heading rather than to the robot. Powers
+        are mixed once and scaled down together if any wheel would exceed 127. */
+    void setDrivePowerByAngle(real_t angle, real_t magnitude=127, real_t turn=0, angleType format=DEGREES, bool fieldRelative=false); //angle is counterclockwise from the right
+    //#endregion
+
+    //#region constructors
+    HolonomicDrive(unsigned char leftFront, unsigned char rightFront, unsigned char leftBack, unsigned char rightBack, unsigned char xAxis=4, unsigned char yAxis=3, unsigned char turnAxis=1, unsigned char deadband=15, unsigned char joystick=1);
+    //#endregion
+
+    //#region input config
+    void configureInput(unsigned char xAxis=4, unsigned char yAxis=3, unsigned char turnAxis=1, unsigned char deadband=15, unsigned char joystick=1, real_t coeff=1, real_t powMap=1);
+    /* All three axes are mapped through the same ResponseCurve */
+    void setFieldCentric(bool fieldCentric);  //whether takeInput() is field-centric (requires gyro)
+    bool isFieldCentric();
+    //#endregion
+    //#region sensors
+    void addSensor(unsigned char gyroPort, unsigned short multiplier=0);
+    real_t gyroVal(angleType format=DEGREES); //counterclockwise is positive
+    void resetGyro();                         //sets current heading as field-centric forward
+    bool hasGyro();
+    //#endregion
+    MotorGroup* wheel(wheelPosition position);
+  private:
+    MotorGroup wheels[4]; //left front, right front, left back, right back
+    //#region input
+    unsigned char xAxis, yAxis, turnAxis, joystick;
+    ResponseCurve inputCurve;
+    bool fieldCentric;
+    //#endregion
+    //#region sensors
+    Gyro gyro;
+    unsigned char gyroPort;
+    //#endregion
+};
+
+#endif
@@ -0,0 +1,77 @@
+/* Records joystick input during operator control and plays it back (e.g. as
+  an autonomous routine)
+
+  Recording and playback happen in SensorCache::update(), so every takeInput()
+  path (JoystickGroup, ButtonGroup, ParallelDrive and user code reading
+  SensorCache or ButtonTracker) sees recorded input exactly as it saw the
+  driver's. Each update is one tick of the stream. Optionally, the counts of
+  two drive encoders are recorded as well, and during playback
+  ParallelDrive::takeInput() adds driftCorrection() to each side's power to
+  keep the drive on its recorded encoder positions.
+
+  Stream format (bytes):
+    header:     'R', leftEncPort, rightEncPort
+    0x00-0x7F:  previous tick repeated (value+1) times
+    0x80|flags: tick with changes, followed by (in order, for each flag set)
+                  AXES (0x08):    16-bit little-endian mask of changed axes
+                                  (bit 6*(joystick-1) + axis-1), then one
+                                  signed byte per changed axis
+                  BUTTONS (0x01): 32-bit little-endian XOR of ButtonTracker mask
+                  LEFT (0x02):    16-bit little-endian change in left encoder count
+                  RIGHT (0x04):   16-bit little-endian change in right encoder count
+                                  (changes beyond +/-32767 are spread over
+                                  several ticks)
+
+  dump() prints the stream as a C initializer list, so a recording can be
+  pasted into a const array (kept in flash) and passed to startPlayback(). */
+
+#ifndef INPUT_RECORDER_INCLUDED
+#define INPUT_RECORDER_INCLUDED
+
+#include "sensorCache.h"  //also includes API
+#include "coreIncludes.h" //for real_t
+
+#ifndef RECORDING_BUFFER_SIZE
+#define RECORDING_BUFFER_SIZE 4096  //bytes of RAM reserved for recording
+#endif
+
+class InputRecorder {
+  public:
+    //recording
+    static void startRecording(unsigned char leftEncPort=0, unsigned char rightEncPort=0);  //encoder top ports to record (0 for none)
+    static void stopRecording();
+    static bool isRecording();
+    static bool overflowed();         //true if recording stopped because buffer was full
+    static unsigned int length();     //bytes recorded
+    static void dump();               //prints recording to stdout
+    //playback
+    static void startPlayback(const unsigned char *stream=NULL, unsigned int length=0);  //plays last recording if stream is NULL
+    static void stopPlayback();
+    static bool isPlaying();
+    static void setCorrection(real_t kP); //motor power added per encoder tick of drift during playback (0 to disable)
+    static int driftCorrection(unsigned char side); //0 for left encoder, 1 for right
+    //called by SensorCache::update()
+    static void record(const SensorSnapshot &values, unsigned long buttons);
+    static void play(SensorSnapshot &values, unsigned long &buttons);
+  private:
+    static unsigned char buffer[RECORDING_BUFFER_SIZE];
+    static unsigned int bufferLength;
+    static bool recording, playing, full;
+    static unsigned char encPorts[2];
+    //encoding state
+    static signed char lastAxes[CACHE_NUM_JOYSTICKS][6];
+    static unsigned long lastButtons;
+    static int lastCounts[2];     //recorded encoder counts (recording) or recorded positions relative to start (playback)
+    static unsigned char run;     //unchanged ticks not yet written
+    static bool write(unsigned char byte);
+    static void flushRun();
+    //decoding state
+    static const unsigned char *stream;
+    static unsigned int streamLength, position;
+    static unsigned char repeats; //ticks left in current run
+    static int startCounts[2];    //actual encoder counts at start of playback
+    static real_t kP;
+    static unsigned char read();
+};
+
+#endif
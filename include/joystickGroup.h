@@ -4,18 +4,19 @@
 #define JOYSTICK_GROUP_INCLUDED
 
 #include "motorGroup.h"
+#include "responseCurve.h"
 
 class JoystickGroup : public MotorGroup {
   public:
     //Reads input from controller and sets group power accordingly. Returns power of group.
     char takeInput();
     //sets up joystick
-    void configureInput(unsigned char axis, double coeff=1, double powMap=1, unsigned char maxAcc100ms=0, unsigned char deadband=10, unsigned char joystick=1);
+    void configureInput(unsigned char axis, real_t coeff=1, real_t powMap=1, unsigned char maxAcc100ms=0, unsigned char deadband=10, unsigned char joystick=1);
 
-    JoystickGroup(unsigned char numMotors, unsigned char motors[]);
-    JoystickGroup(unsigned char numMotors, unsigned char axis, unsigned char motors[], double coeff=1, double powMap=1, unsigned char maxAcc100ms=60, unsigned char deadband=10, unsigned char joystick=1);
-    JoystickGroup(unsigned char numMotors, unsigned char motors[], unsigned char encPort1, unsigned char encPort2, double coeff=1);
-    JoystickGroup(unsigned char numMotors, unsigned char motors[], unsigned char potPort, bool potReversed=false);
+    JoystickGroup(unsigned char numMotors, const unsigned char motors[]);
+    JoystickGroup(unsigned char numMotors, unsigned char axis, const unsigned char motors[], real_t coeff=1, real_t powMap=1, unsigned char maxAcc100ms=60, unsigned char deadband=10, unsigned char joystick=1);
+    JoystickGroup(unsigned char numMotors, const unsigned char motors[], unsigned char encPort1, unsigned char encPort2, real_t coeff=1);
+    JoystickGroup(unsigned char numMotors, const unsigned char motors[], unsigned char potPort, bool potReversed=false);
 
     //accessors and mutators
       //state
@@ -29,9 +30,7 @@ class JoystickGroup : public MotorGroup {
     void stopRamping();
   private:
     unsigned char axis, joystick;
-    unsigned char deadband; //magnitude of the range of motor values around 0 for which motors are not engaged
-    double powMap;          //degree of polynomial to which inputs are mapped (1 for linear)
-    double coeff;           //factor by which motor powers are multiplied (after all other calculations)
+    ResponseCurve curve;    //maps inputs to powers using coeff, powMap and deadband given to configureInput()
     bool active;            //whether group is accepting input
     //ramping
     bool ramping;
@@ -8,9 +8,23 @@
 #define MOTOR_GROUP_INCLUDED
 
 #include <API.h>
+#include "controlTypes.h"
+#include "timer.h"
 
-class PID;
-class Timer;
+#define MAX_GROUP_MOTORS 10
+
+enum tuningRule { ZIEGLER_NICHOLS, TYREUS_LUYBEN };
+/* Used for specifying how autotunePosPID() turns the ultimate gain Ku and
+  period Tu into PID gains. Ziegler-Nichols (kP=0.6Ku, Ti=Tu/2, Td=Tu/8)
+  responds quickly with some overshoot; Tyreus-Luyben (kP=Ku/2.2, Ti=2.2Tu,
+  Td=Tu/6.3) is more conservative. */
+
+struct AutotuneResult {
+  bool success;           //false if the relay test timed out before measuring enough cycles
+  real_t ultimateGain;    //motor power per unit of position
+  real_t ultimatePeriod;  //milliseconds
+  real_t kP, kI, kD;      //gains applied (kI and kD per millisecond, see autotunePosPID())
+};
 
 class MotorGroup {
   public:
@@ -18,15 +32,27 @@ class MotorGroup {
     /*Sets all motors in group to the specified power.
       If overrideAbsolutes is true, ignores absolute minimums and maximums */
     char getPower();  //returns the last set power of the motors in the group
+    template <class Ports>
+    void usePorts();
+    /* Makes setPower() set the motors through Ports::setPower() (see
+      motorPorts.h), which calls motorSet() once per port without looping.
+      Does nothing unless Ports lists the group's ports in the same order.
+      Defined in motorPorts.h. */
 
-    MotorGroup(unsigned char numMotors, unsigned char motors[]);
-    MotorGroup(unsigned char numMotors, unsigned char motors[], unsigned char encPort1, unsigned char encPort2, double coeff=1);
-    MotorGroup(unsigned char numMotors, unsigned char motors[], unsigned char potPort, bool potReversed=false);
+    MotorGroup(unsigned char numMotors, const unsigned char motors[]);  //motor ports are copied, so motors need not outlive the group
+    MotorGroup(unsigned char numMotors, const unsigned char motors[], unsigned char encPort1, unsigned char encPort2, real_t coeff=1);
+    MotorGroup(unsigned char numMotors, const unsigned char motors[], unsigned char potPort, bool potReversed=false);
     //sensors
-    void addSensor(unsigned char encPort1, unsigned char encPort2, double coeff=1, bool setAsDefault=true); //associates a sensor with the group. If setAsDefault is true, potIsDefault is adjusted accordingly
+    void addSensor(unsigned char encPort1, unsigned char encPort2, real_t coeff=1, bool setAsDefault=true); //associates a sensor with the group. If setAsDefault is true, potIsDefault is adjusted accordingly
     void addSensor(unsigned char potPort, bool reversed=false, bool setAsDefault=true);
     int encoderVal(bool rawValue=false);                                  //if encoder is attached, returns encoder value of associated encoder (multiplied by encCoeff unless rawValue is true), otherwise, it returns 0
-    void resetEncoder();                                                  //resets associated encoder to 0
+    void resetEncoder();                                                  //resets value returned by encoderVal() to 0 (the hardware count is left untouched)
+    int encoderCount();                                                   //returns the raw accumulated count of the associated encoder, which is never reset by the library (0 if no encoder is attached)
+    real_t encoderDelta(int &count, bool rawValue=false);
+    /* Returns the distance moved (multiplied by encCoeff unless rawValue is
+      true) since encoderCount() was equal to count, then updates count to the
+      current encoderCount(). Lets any number of consumers track movement
+      against their own snapshots without resetting the encoder. */
     int potVal();                                                         //same as encoderVal(), but returns 4095 - the value of the potentiometer if potReversed is true
     int getPosition();                                                    //returns either encoderVal() or potVal() depending on the value of potIsDefault
     //automovement
@@ -35,11 +61,41 @@ class MotorGroup {
     void stopManeuver();
     void executeManeuver();                                                                                              //moves group toward target and updates maneuver progress
       //position targeting
-    void posPIDinit(double kP, double kI, double kD, unsigned short minSampleTime=30, double integralMax=0, bool useTimeAdjustment=false);  //sets PID constants used for maintaining target position
+    void posPIDinit(real_t kP, real_t kI, real_t kD, unsigned short minSampleTime=30, real_t integralMax=0, bool useTimeAdjustment=false);
+    /* Sets PID constants used for maintaining target position. Output is
+      limited to motor power, with conditional integration anti-windup. */
+    ControlPID& getPosPID();  //for changing other options of the position PID
+    bool posPIDinitInBank(real_t kP, real_t kI, real_t kD, real_t integralMax=0);
+    /* Like posPIDinit(), but registers the controller in PIDBank, which then
+      sets the group's power while position targeting is active and no
+      maneuver is executing (maintainTargetPos() does nothing). Starts the
+      bank's Scheduler job with the default period unless
+      PIDBank::runInBackground() was already called. Gains are per bank
+      update period. Returns false if the bank is full. */
+    AutotuneResult autotunePosPID(int setpoint, tuningRule rule=ZIEGLER_NICHOLS, char relayPower=60, int hysteresis=10, unsigned char cycles=4, unsigned short timeout=20000);
+    /* Finds position PID gains with a relay test: blocks while switching the
+      motors between +relayPower and -relayPower each time the position
+      crosses setpoint (+/- hysteresis), measures the amplitude and period of
+      the resulting oscillation over the specified number of cycles (after
+      one settling cycle), and derives gains from them using rule. Positive
+      power must increase getPosition(). On success, the gains are applied
+      to the position controller (posPIDinit() with useTimeAdjustment and a
+      minimum sample time of a tenth of the period, so kI and kD are per
+      millisecond, or converted to the period of PIDBank if
+      posPIDinitInBank() was called) and the group holds setpoint. Timeout
+      is in milliseconds. */
     void setTargetPosition(int position); //sets target and activates position targeting
     void maintainTargetPos();							//moves toward or tries to maintain target position. posPIDinit() must have been called prior to this funciton
     bool errorLessThan(int margin);       //returns true if PID error < margin
+      //background execution
+    void runInBackground(unsigned short period=10);
+    /* Registers a Scheduler job which calls executeManeuver() while a maneuver
+      is executing and maintainTargetPos() otherwise, every period
+      milliseconds. Once the Scheduler is started, blocking calls to
+      goToPosition() sleep until the maneuver completes. */
+    bool runningInBackground();
     //accessors and mutators
+    unsigned char getMotor(unsigned char index=0); //returns port of specified motor in group
       //sensors
     bool isPotReversed();       //returns false if no potentiometer is attached
     void setPotReversed(bool reversed);
@@ -64,7 +120,8 @@ class MotorGroup {
     void setMaxPowerAtAbs(char power);
   private:
     unsigned char numMotors;
-    unsigned char* motors;      //array of motors in group
+    unsigned char motors[MAX_GROUP_MOTORS]; //ports of motors in group
+    void (*writeMotors)(char power);        //sets every motor in group if usePorts() was called, otherwise NULL
     //absolutes
     int absMin, absMax;         //the maximum and minimum potentiometer values for which the motor group will set motor powers above a certain threshold
     char maxPowerAtAbs;         //see below
@@ -76,16 +133,25 @@ class MotorGroup {
     unsigned short maneuverTimeout; //the amount of time (milliseconds) for which a position past the target position must be detected for maneuver to stop
     bool forward;                   //whether target is forward (in the positive motor power direction) of starting position
     bool maneuverExecuting;         //whether a maneuver is currently in progress
-    Timer* maneuverTimer;           //tracks timeout state of maneuvers
+    TickTimer maneuverTimer;        //tracks timeout state of maneuvers
 		//position targeting
-		PID* posPID;
+		ControlPID posPID;
+    bool hasPosPID;       //whether posPIDinit() has been called
+    char bankId;          //id of controller in PIDBank (-1 if posPIDinitInBank() has not been called)
     bool targetingActive;
     //sensors
     Encoder encoder;
-    double encCoeff;
+    unsigned char encPort;  //top port of encoder
+    real_t encCoeff;
+    int encoderZero;    //encoderCount() at last resetEncoder()
     unsigned char potPort;
     bool potReversed;   //whether potentiometer is reversed (affects potVal() output)
     bool potIsDefault;  //whether potentiometer (as opposed to encoder) is default sensor for position measurements
+    //background execution
+    bool scheduled;     //whether runInBackground() has been called
+    static void backgroundJob(void *group);
+    static real_t bankInput(void *group);
+    static void bankOutput(void *group, real_t power);
 };
 
 
@@ -0,0 +1,91 @@
+/* Compile-time descriptions of robot ports for use in config.h
+
+  MotorPorts<ports...> is a port list fixed at compile time. Its static_asserts
+  reject ports outside 1-10, lists longer than MAX_GROUP_MOTORS and ports
+  listed twice, and its setPower() expands to one motorSet() call per port
+  with no loop. Pass count and list to a MotorGroup (or derived) constructor,
+  then call the group's usePorts() so that setPower() uses the unrolled calls.
+  distinctMotorPorts<Groups...>() and distinctPorts<ports...>() let config.h
+  static_assert that no port is shared between groups or sensors. */
+
+#ifndef MOTOR_PORTS_INCLUDED
+#define MOTOR_PORTS_INCLUDED
+
+#include "motorGroup.h" //also includes API
+
+//#region port checks
+template <unsigned char... ports>
+constexpr bool distinctPorts() {
+  const unsigned char list[] = { 0, ports... }; //leading 0 keeps list nonempty
+
+  for (unsigned char i=1; i<sizeof(list); i++)
+    for (unsigned char j=i+1; j<sizeof(list); j++)
+      if (list[i] == list[j]) return false;
+
+  return true;
+}
+
+template <unsigned char min, unsigned char max, unsigned char... ports>
+constexpr bool portsInRange() {
+  const unsigned char list[] = { min, ports... };
+
+  for (unsigned char i=1; i<sizeof(list); i++)
+    if (list[i] < min || list[i] > max) return false;
+
+  return true;
+}
+//#endregion
+
+//#region motor port lists
+template <unsigned char... ports>
+struct PortList {};
+
+template <unsigned char... ports>
+struct MotorPorts {
+  static_assert(sizeof...(ports) > 0 && sizeof...(ports) <= MAX_GROUP_MOTORS, "motor group must have between 1 and MAX_GROUP_MOTORS motors");
+  static_assert(portsInRange<1, 10, ports...>(), "motor ports must be between 1 and 10");
+  static_assert(distinctPorts<ports...>(), "motor port listed twice in group");
+
+  typedef PortList<ports...> List;
+  static constexpr unsigned char count = sizeof...(ports);
+  static constexpr unsigned char list[] = { ports... };
+
+  static void setPower(char power) {
+    int expand[] = { (motorSet(ports, power), 0)... };
+    (void)expand;
+  }
+};
+
+template <unsigned char... ports>
+constexpr unsigned char MotorPorts<ports...>::list[];
+
+template <class... Lists>
+struct JoinedPorts;
+
+template <unsigned char... ports>
+struct JoinedPorts<PortList<ports...>> {
+  static constexpr bool distinct = distinctPorts<ports...>();
+};
+
+template <unsigned char... first, unsigned char... second, class... rest>
+struct JoinedPorts<PortList<first...>, PortList<second...>, rest...> : JoinedPorts<PortList<first..., second...>, rest...> {};
+
+template <class... Groups>
+constexpr bool distinctMotorPorts() { //true if no port appears in more than one of the MotorPorts Groups
+  return JoinedPorts<typename Groups::List...>::distinct;
+}
+//#endregion
+
+//#region group binding
+template <class Ports>
+void MotorGroup::usePorts() {
+  if (Ports::count != numMotors) return; //possible debug location
+
+  for (unsigned char i=0; i<numMotors; i++)
+    if (Ports::list[i] != motors[i]) return; //possible debug location
+
+  writeMotors = Ports::setPower;
+}
+//#endregion
+
+#endif
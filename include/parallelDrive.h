@@ -8,12 +8,15 @@
 #define PARALLEL_DRIVE_INCLUDED
 
 #include "coreIncludes.h" //also includes cmath
+#include "binaryAngle.h"
+#include "controlTypes.h"
+#include "timer.h"
+#include "trajectory.h"
+#include "responseCurve.h"
+#include "joystickGroup.h"
 #include <API.h>
 
-class JoystickGroup;
-class PID;
 class Ramper;
-class Timer;
 
 //#region enums
 enum encoderConfig { UNASSIGNED, LEFT, RIGHT, AVERAGE };
@@ -32,6 +35,26 @@ enum correctionType { NONE, GYRO, ENCODER, AUTO };
     gyro value of 0, ENCODER tries to maintain an difference in the drive side
     encoder counts of zero, and AUTO will cause the program to choose
     automatically based on the available sensors (encoders given preference) */
+enum segmentType { DRIVE_SEGMENT, TURN_SEGMENT, ARC_SEGMENT };
+/* Types of maneuvers which can be queued. ARC_SEGMENT drives along a circle
+    of a given radius for a given change in heading. */
+//#endregion
+
+//#region maneuver queue
+#define MAX_SEGMENTS 16
+
+struct ManeuverSegment {
+  segmentType type;
+  real_t amount;  //distance (inches) for drives, angle (degrees) for turns and arcs
+  real_t radius;  //arcs only (inches, positive turns counterclockwise)
+  char maxPower;
+};
+//#endregion
+
+//#region path following
+struct Waypoint {
+  real_t x, y;  //inches, in the same frame as ParallelDrive::x() and y()
+};
 //#endregion
 
 //#region defaults
@@ -40,7 +63,7 @@ struct TurnDefaults {
   bool useGyro;
   char brakePower;
   unsigned short waitAtEnd, sampleTime, brakeDuration;
-  double rampConst1, rampConst2, rampConst3, rampConst4, rampConst5;  // initialPower/kP, maxPower/kD, finalPower/error, 0/maneuver timeout, irrelevant/kI
+  real_t rampConst1, rampConst2, rampConst3, rampConst4, rampConst5;  // initialPower/kP, maxPower/kD, finalPower/error, 0/maneuver timeout, irrelevant/kI
 };
 extern TurnDefaults tDefs;
 
@@ -49,13 +72,39 @@ struct DriveDefaults {
   bool rawValue;            //whether to use encoder clicks (as opposed to inches)
   char brakePower;
   unsigned short waitAtEnd, sampleTime, brakeDuration, moveTimeout;
-  double rampConst1, rampConst2, rampConst3, rampConst4, rampConst5; //same as turn
-  double kP_c, kI_c, kD_c;  //correction PID constants
-  double minSpeed;  //minimum speed (inches or clicks per second) which will not trigger a move timeout
+  real_t rampConst1, rampConst2, rampConst3, rampConst4, rampConst5; //same as turn
+  real_t kP_c, kI_c, kD_c;  //correction PID constants
+  real_t minSpeed;  //minimum speed (inches or clicks per second) which will not trigger a move timeout
 };
 extern DriveDefaults dDefs;
+
+struct PursuitDefaults {
+  real_t lookahead;     //inches
+  real_t endTolerance;  //distance (inches) from last waypoint at which path is complete
+  char maxPower, minPower;  //power is reduced linearly from maxPower to minPower once last waypoint is within lookahead distance
+  unsigned short waitAtEnd;
+};
+extern PursuitDefaults pDefs;
+
+struct TrajectoryDefaults {
+  real_t kV;              //motor power per inch/second of side velocity
+  real_t kX, kY, kTheta;  //gains on along-track (1/s), cross-track (1/inch^2) and heading (1/s) error
+  real_t endTolerance;    //along-track distance (inches) from last sample at which trajectory is complete
+  unsigned short waitAtEnd;
+};
+extern TrajectoryDefaults trDefs;
 //#endregion
 
+struct DriveWheel {
+  real_t diameter;
+  real_t encCoeff;  //inches per encoder tick
+
+  constexpr explicit DriveWheel(real_t diameter, real_t gearRatio=1) : diameter(diameter), encCoeff(encoderCoefficient(diameter, gearRatio)) {}
+};
+/* Wheel geometry for addSensor(). Declared constexpr (as in config.h), the
+  encoder coefficient is computed at compile time. gearRatio is from wheel
+  to encoder. */
+
 class ParallelDrive {
   public:
     //#region main methods
@@ -63,57 +112,109 @@ class ParallelDrive {
     void setLeftPower(char power);
     void setRightPower(char power);
     void setDrivePower(char left, char right);
+    template <class LeftPorts, class RightPorts>
+    void usePorts() { leftDrive.usePorts<LeftPorts>(); rightDrive.usePorts<RightPorts>(); } //see MotorGroup::usePorts()
     //#endregion
 
     //#region constructors
-    ParallelDrive(unsigned char numMotorsL, unsigned char numMotorsR, unsigned char leftMotors[], unsigned char rightMotors[], unsigned char lEncPort1, unsigned char lEncPort2, bool lReversed, unsigned char rEncPort1, unsigned char rEncPort2, bool rReversed, double wheelDiameter, double gearRatio=1);
-    ParallelDrive(unsigned char numMotorsL, unsigned char numMotorsR, unsigned char leftMotors[], unsigned char rightMotors[], double coeff=1, double powMap=1, unsigned char maxAcc100ms=0, unsigned char deadband=10, unsigned char leftAxis=3, unsigned char rightAxis=2, unsigned char joystick=1); //configures tank input
-    ParallelDrive(unsigned char movementAxis, unsigned char turningAxis, unsigned char numMotorsL, unsigned char numMotorsR, unsigned char leftMotors[], unsigned char rightMotors[], double coeff=1);  //configures arcade input
+    ParallelDrive(unsigned char numMotorsL, unsigned char numMotorsR, const unsigned char leftMotors[], const unsigned char rightMotors[], unsigned char lEncPort1, unsigned char lEncPort2, bool lReversed, unsigned char rEncPort1, unsigned char rEncPort2, bool rReversed, real_t wheelDiameter, real_t gearRatio=1);
+    ParallelDrive(unsigned char numMotorsL, unsigned char numMotorsR, const unsigned char leftMotors[], const unsigned char rightMotors[], real_t coeff=1, real_t powMap=1, unsigned char maxAcc100ms=0, unsigned char deadband=10, unsigned char leftAxis=3, unsigned char rightAxis=2, unsigned char joystick=1); //configures tank input
+    ParallelDrive(unsigned char movementAxis, unsigned char turningAxis, unsigned char numMotorsL, unsigned char numMotorsR, const unsigned char leftMotors[], const unsigned char rightMotors[], real_t coeff=1);  //configures arcade input
     //#endregion
 
     //#region input config
-    void configureTankInput(double coeff=1, double powMap=1, unsigned char maxAcc100ms=0, unsigned char deadband=10, unsigned char leftAxis=3, unsigned char rightAxis=2, unsigned char joystick=1);
-    void configureArcadeInput(unsigned char movementAxis=1, unsigned char turningAxis=2, double coeff=1);
+    void configureTankInput(real_t coeff=1, real_t powMap=1, unsigned char maxAcc100ms=0, unsigned char deadband=10, unsigned char leftAxis=3, unsigned char rightAxis=2, unsigned char joystick=1);
+    void configureArcadeInput(unsigned char movementAxis=1, unsigned char turningAxis=2, real_t coeff=1, unsigned char joystick=1, real_t powMap=1, unsigned char deadband=0);
+    /* Both axes are mapped through the same ResponseCurve before being mixed */
     //#endregion
     //#region sensors
-    void addSensor(unsigned char encPort1, unsigned char encPort2, bool reversed, encoderConfig side, double wheelDiameter=0, double gearRatio=1); //encCoeff calculated from diameter and gear ratio (from wheel to encoder)
+    void addSensor(unsigned char encPort1, unsigned char encPort2, bool reversed, encoderConfig side, real_t wheelDiameter=0, real_t gearRatio=1); //encCoeff calculated from diameter and gear ratio (from wheel to encoder)
+    void addSensor(unsigned char encPort1, unsigned char encPort2, bool reversed, encoderConfig side, const DriveWheel &wheel);
     void addSensor(unsigned char gyroPort, gyroCorrectionType correction=MEDIUM, unsigned short multiplier=0);
-    double encoderVal(encoderConfig side=UNASSIGNED, bool rawValue=false, bool absolute=true);
+    real_t encoderVal(encoderConfig side=UNASSIGNED, bool rawValue=false, bool absolute=true);
     /* Returns the result of calling encoderVal() on motor group of specified
         side. When side is UNASSIGNED, encConfig is used to determine which
         encoders to use. AVERAGE returns the mean of the two sides' values, or
         that of their absolute values if absolute is true. */
     void resetEncoders();                       //When side is UNASSIGNED, encConfig is used to determine which encoder to reset
-    double gyroVal(angleType format=DEGREES);
+    real_t gyroVal(angleType format=DEGREES);
     void resetGyro();
-    double absAngle(angleType format=DEGREES);  //gyroVal() + angleOffset
+    real_t absAngle(angleType format=DEGREES);  //absHeading() in [-180, 180) degrees or [-pi, pi) radians
+    bam absHeading();                           //gyroVal() + angleOffset
     //#endregion
     //#region position tracking
     void updatePosition();  //takes encoder (and possibly gyro) input and updates robot's current position
-    double calculateWidth(unsigned short duration=10000, unsigned short sampleTime=200, char power=80, unsigned short reverseDelay=750);
+    real_t calculateWidth(unsigned short duration=10000, unsigned short sampleTime=200, char power=80, unsigned short reverseDelay=750);
     /* Causes robot to spin and uses gyro and encoder input to calculate width
         of its drive, which is returned and automatically set. Power is the
         motor power used in turning, and reverse delay is the amount of time for
         which samples are not taken as drive changes spinning direction. */
     //#endregion
     //#region automovement
-    void turn(double angle, bool runAsManeuver=false, double rc1=tDefs.rampConst1, double rc2=tDefs.rampConst2, double rc3=tDefs.rampConst3, double rc4=tDefs.rampConst4, double rc5=tDefs.rampConst5, angleType format=tDefs.defAngleType, unsigned short waitAtEnd=tDefs.waitAtEnd, unsigned short sampleTime=tDefs.sampleTime, char brakePower=tDefs.brakePower, unsigned short brakeDuration=tDefs.brakeDuration, bool useGyro=tDefs.useGyro);
-    void drive(double dist, bool runAsManeuver=false, double rc1=dDefs.rampConst1, double rc2=dDefs.rampConst2, double rc3=dDefs.rampConst3, double rc4=dDefs.rampConst4, double rc5=dDefs.rampConst5, unsigned short waitAtEnd=dDefs.waitAtEnd, double kP=dDefs.kP_c, double kI=dDefs.kI_c, double kD=dDefs.kD_c, correctionType correction=dDefs.defCorrectionType, bool rawValue=dDefs.rawValue, double minSpeed=dDefs.minSpeed, unsigned short moveTimeout=dDefs.moveTimeout, char brakePower=dDefs.brakePower, unsigned short brakeDuration=dDefs.brakeDuration, unsigned short sampleTime=dDefs.sampleTime);
+    void turn(real_t angle, bool runAsManeuver=false, real_t rc1=tDefs.rampConst1, real_t rc2=tDefs.rampConst2, real_t rc3=tDefs.rampConst3, real_t rc4=tDefs.rampConst4, real_t rc5=tDefs.rampConst5, angleType format=tDefs.defAngleType, unsigned short waitAtEnd=tDefs.waitAtEnd, unsigned short sampleTime=tDefs.sampleTime, char brakePower=tDefs.brakePower, unsigned short brakeDuration=tDefs.brakeDuration, bool useGyro=tDefs.useGyro);
+    void drive(real_t dist, bool runAsManeuver=false, real_t rc1=dDefs.rampConst1, real_t rc2=dDefs.rampConst2, real_t rc3=dDefs.rampConst3, real_t rc4=dDefs.rampConst4, real_t rc5=dDefs.rampConst5, unsigned short waitAtEnd=dDefs.waitAtEnd, real_t kP=dDefs.kP_c, real_t kI=dDefs.kI_c, real_t kD=dDefs.kD_c, correctionType correction=dDefs.defCorrectionType, bool rawValue=dDefs.rawValue, real_t minSpeed=dDefs.minSpeed, unsigned short moveTimeout=dDefs.moveTimeout, char brakePower=dDefs.brakePower, unsigned short brakeDuration=dDefs.brakeDuration, unsigned short sampleTime=dDefs.sampleTime);
     /* rc args explained in turnDefaults definition */
     void executeManeuver();                             //executes turn and drive maneuvers
-    double maneuverProgress(angleType format=DEGREES);  //returns absolute value odistance traveled or angle turned while maneuver is in progress
+    real_t maneuverProgress(angleType format=DEGREES);  //returns absolute value odistance traveled or angle turned while maneuver is in progress
     bool maneuverExecuting();
+    void turnToHeading(bam heading, bool runAsManeuver=false);
+    /* Turns the shorter way to the specified absolute heading (see
+        absHeading(), or theta() if there is no gyro) using the turn defaults.
+        Not mirrored by setTurnReversal(). */
+      //#subregion path following
+    void followPath(const Waypoint path[], unsigned char numPoints, bool runAsManeuver=false, real_t lookahead=pDefs.lookahead, char maxPower=pDefs.maxPower, real_t endTolerance=pDefs.endTolerance, char minPower=pDefs.minPower, unsigned short waitAtEnd=pDefs.waitAtEnd);
+    /* Drives forward through waypoints using pure pursuit: each update, the
+        robot steers along the arc which passes through the point lookahead
+        inches ahead of it on the path. Requires position tracking (encoders
+        on both sides and a nonzero width). path is not copied, so it must
+        remain valid until the maneuver ends. */
+    void followTrajectory(const Trajectory &trajectory, bool runAsManeuver=false, bool indexByTime=true, real_t kV=trDefs.kV, real_t kX=trDefs.kX, real_t kY=trDefs.kY, real_t kTheta=trDefs.kTheta, real_t endTolerance=trDefs.endTolerance, unsigned short waitAtEnd=trDefs.waitAtEnd);
+    /* Plays back a table generated by `make trajectories` against the
+        tracked position. The target sample is chosen by time since the start
+        of the maneuver if indexByTime is true, and otherwise by distance
+        driven. Sample velocity and curvature are fed forward (scaled by kV)
+        and position and heading errors are corrected with a nonlinear
+        (Kanayama) tracking controller. Ends within endTolerance of the last
+        sample or a second after the trajectory's scheduled end. */
+      //#endsubregion
+      //#subregion maneuver queue
+    bool queueDrive(real_t dist, char maxPower=dDefs.rampConst2);
+    bool queueTurn(real_t angle, angleType format=tDefs.defAngleType);
+    bool queueArc(real_t radius, real_t angle, angleType format=tDefs.defAngleType, char maxPower=dDefs.rampConst2);
+    /* Add a segment to the end of the maneuver queue (distances in inches).
+        Return false if the queue is full or (for arcs) radius is less than
+        half the width of the drive. Negative dists and arc angles move
+        backward. */
+    void runQueue(bool runAsManeuver=false);
+    /* Executes queued segments in order. Consecutive drive and arc segments
+        in the same direction are blended: the first ends at the second's
+        maximum power instead of ramping down, and the second starts at the
+        power the first ended at. Other segments start as soon as the
+        previous one reaches its target, without braking or waiting. Only the
+        last segment brakes and waits at the end. The queue is emptied when
+        it finishes or is cancelled. */
+    void cancelQueue();             //stops drive and empties queue
+    int currentSegment();           //index of executing segment, or -1 if queue is not running
+    unsigned char queuedSegments(); //number of segments in queue (including those already executed)
+      //#endsubregion
+    void runInBackground(unsigned short period=10);
+    /* Registers a Scheduler job which calls updatePosition() and
+        executeManeuver() every period milliseconds. Once the Scheduler is
+        started, blocking turns and drives sleep until the maneuver completes
+        instead of running it themselves. */
+    bool runningInBackground();
     //#endregion
     //#region accessors and mutators
       //#subregion sensors
     void setEncoderConfig(encoderConfig config);
-    void setAbsAngle(double angle=0, angleType format=DEGREES); //sets angleOffset so that current absAngle is equal to specified angle
+    void setAbsAngle(real_t angle=0, angleType format=DEGREES); //sets angleOffset so that current absAngle is equal to specified angle
     bool hasGyro();
       //#endsubregion
       //#subregion position tracking
-    void setWidth(double inches);
-    void setRobotPosition(double x, double y, double theta, angleType format=DEGREES, bool updateAngleOffset=true); //sets angleOffset so that current absAngle is equal to theta if setAbsAngle if true
-    double x(); double y(); double theta(angleType format=DEGREES);
+    void setWidth(real_t inches);
+    void setRobotPosition(real_t x, real_t y, real_t theta, angleType format=DEGREES, bool updateAngleOffset=true); //sets angleOffset so that current absAngle is equal to theta if setAbsAngle if true
+    real_t x(); real_t y(); real_t theta(angleType format=DEGREES);  //theta is in [-180, 180) degrees or [-pi, pi) radians
+    bam heading();  //orientation as tracked by updatePosition()
       //#endsubregion
       //#subregion autonomous
     void setCorrectionType(correctionType type);
@@ -121,33 +222,84 @@ class ParallelDrive {
       //#endsubregion
     //#endregion
   private:
-    JoystickGroup* leftDrive;
-    JoystickGroup* rightDrive;
+    JoystickGroup leftDrive;
+    JoystickGroup rightDrive;
     //#region arcade
     bool arcadeInput;
-    double coeff;
+    ResponseCurve arcadeCurve;
     unsigned char moveAxis, turnAxis, joystick;
     //#endregion
     //#region sensors
-    double wheelDiameter; //used for calculating encoder coefficients
+    real_t wheelDiameter; //used for calculating encoder coefficients
     void updateEncConfig(); //automatically updates encConfig when a new encoder is attached
+    real_t combineSides(real_t left, real_t right, encoderConfig side=UNASSIGNED, bool absolute=true); //combines values from each side as encoderVal() does
     encoderConfig encConfig;
     Gyro gyro;
-    int angleOffset;  //amount added to gyro values to obtain absolute angle (degrees)
+    unsigned char gyroPort;
+    bam angleOffset;  //amount added to gyro values to obtain absolute angle
     //#endregion
     //#region position tracking
-    double xPos, yPos, orientation; //orientation is in radians
-    double width;                   //width of drive in inches (wheel well to wheel well)
-    Timer* positionTimer;
+    real_t xPos, yPos;
+    bam orientation;
+    int leftPositionCount, rightPositionCount;  //encoder counts at last position update
+    real_t width;                   //width of drive in inches (wheel well to wheel well)
+    TickTimer positionTimer;  //tracks time since last position update
     unsigned short minSampleTime; //minimum time between updates of robot's position
     gyroCorrectionType gyroCorrection;
     //#endregion
     //#region automovement
     void initializeDefaults();  //initializes default automovement values (called by constructors)
-    double target;  //angle or distance
-    Ramper* ramp;    //controls motor power ramping during maneuver
+    real_t target;  //angle or distance
+    Ramper* ramp;    //controls motor power ramping during maneuver (points into rampSlot)
+    union RampSlot { //in-place storage for ramp, so starting a maneuver doesn't allocate
+      ControlQuadRamp quadRamp;
+      ControlPID pid;
+      RampSlot() {}
+    } rampSlot;
     unsigned short finalDelay, sampleTime, brakeDelay;
     char brakePower;
+      //#subregion path following
+    bool isFollowing;
+    const Waypoint* path;
+    unsigned char numPoints;
+    unsigned char pathSegment;  //index of first point of path segment containing lookahead point
+    real_t pathT;               //fraction of way along that segment of lookahead point
+    real_t lookahead, endTolerance;
+    char maxPower, minPower;
+    const Trajectory* trajectory; //NULL when following waypoints
+    unsigned short trajectoryIndex;
+    bool indexByTime;
+    real_t trajectoryDist;        //distance driven since start of trajectory
+    real_t kV, kX, kY, kTheta;
+    void followPathUpdate();    //called by executeManeuver()
+    void followTrajectoryUpdate();
+      //#endsubregion
+      //#subregion maneuver queue
+    ManeuverSegment segments[MAX_SEGMENTS];
+    unsigned char numSegments, segmentIndex;
+    bool queueRunning;
+    int lastPower;  //ramp output at last drive sample, carried into blended segments
+    real_t leftScale, rightScale; //multipliers of each side's power (and expected distance) while following an arc
+    bool queueSegment(segmentType type, real_t amount, real_t radius, char maxPower);
+    bool blendable(const ManeuverSegment &from, const ManeuverSegment &to);
+    bool nextSegment(); //starts next queued segment. Returns false if there is none
+    void startSegment(bool carryPower);
+    void startDrive(real_t dist, bool runAsManeuver, real_t rc1, real_t rc2, real_t rc3, real_t rc4, real_t rc5, unsigned short waitAtEnd, real_t kP, real_t kI, real_t kD, correctionType correction, bool rawValue, real_t minSpeed, unsigned short moveTimeout, char brakePower, unsigned short brakeDuration, unsigned short sampleTime, real_t leftScale, real_t rightScale);
+    /* drive() with side scales for arc segments, which must be in place
+      before isDriving lets the background job execute the maneuver */
+    void clearQueue();
+      //#endsubregion
+      //#subregion end of maneuver
+    enum { RAMPING, BRAKING, SETTLING } maneuverPhase;
+    /* After termination conditions are met, executeManeuver() applies
+        brakePower for brakeDelay milliseconds (BRAKING) and then waits with
+        the motors stopped for finalDelay milliseconds (SETTLING) before the
+        maneuver ends, returning immediately on every call. */
+    TickTimer phaseTimer;     //tracks time spent in current phase
+    void beginEndPhase(char leftBrakePower, char rightBrakePower);
+    void updateEndPhase();
+    void waitForManeuver(); //blocks until maneuver is complete
+      //#endsubregion
       //#subregion termination conditions
     bool maneuverFinished();
     /* Checks if termination conditions are met based on current robot state.
@@ -155,9 +307,9 @@ class ParallelDrive {
         isTurning and isDriving. */
     bool quadRamping; //if this is true, maneuver will terminate once progress surpasses <target>
                       //if it is false, maneuver will terminate once <maneuverTimer> surpasses <timeout>
-    Timer* maneuverTimer; //tracks how long robot has been within <margin> of <target>
+    TickTimer maneuverTimer;  //tracks how long robot has been within <margin> of <target>
     unsigned short timeout;
-    double margin;
+    real_t margin;
       //#endsubregion
       //#subregion turning
     bool isTurning;
@@ -168,14 +320,17 @@ class ParallelDrive {
       //#subregion driving
     bool isDriving;
     bool rawValue;
-    double minSpeed;
+    real_t minSpeed;
     unsigned short moveTimeout; //amount of time with no movement after which a maneuver will terminate
     correctionType correction;
-    PID* correctionPID;
-    double leftDist, rightDist, totalDist;
-    Timer* sampleTimer;
-    Timer* moveTimer;
+    ControlPID correctionPID;
+    real_t leftDist, rightDist, totalDist;
+    int leftManeuverCount, rightManeuverCount;  //encoder counts at start of turn or last drive sample
+    TickTimer sampleTimer;    //tracks time since last drive sample
+    TickTimer moveTimer;      //tracks time since drive last moved faster than minSpeed
       //#endsubregion
+    bool scheduled; //whether runInBackground() has been called
+    static void backgroundJob(void *drive);
     //#endregion
 };
 
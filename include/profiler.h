@@ -0,0 +1,87 @@
+/* Measures how long each control subsystem takes per update and how regularly
+  it runs, using micros()
+
+  The library wraps each subsystem update (drive input, odometry, maneuvers,
+  position targeting and the Scheduler's tick) in PROFILE_SCOPE(id), which
+  expands to nothing unless PROFILING is defined (see common.mk). Each profile
+  aggregates every object of its kind (e.g. all MotorGroups' position
+  targeting) and records:
+    - min/max/mean execution time
+    - a histogram of execution times in power-of-2 buckets from 32 us to 2 ms
+    - min/max interval between the starts of successive updates, which
+      shows the jitter seen by sampleTime-gated logic
+    - overruns, updates which took longer than the profile's deadline (the
+      loop period set with setLoopPeriod() unless set with setDeadline())
+
+  User code can register its own profiles with add(). */
+
+#ifndef PROFILER_INCLUDED
+#define PROFILER_INCLUDED
+
+#include <API.h>
+
+#define MAX_PROFILES 12
+#define PROFILE_BUCKETS 8 //bucket i counts times below 32<<i microseconds (the last counts everything else)
+
+enum ProfileId {
+  PROFILE_DRIVE_INPUT,      //ParallelDrive::takeInput()
+  PROFILE_ODOMETRY,         //ParallelDrive::updatePosition() (only updates which are not rate limited)
+  PROFILE_DRIVE_MANEUVER,   //ParallelDrive::executeManeuver()
+  PROFILE_GROUP_MANEUVER,   //MotorGroup::executeManeuver()
+  PROFILE_GROUP_TARGET,     //MotorGroup::maintainTargetPos()
+  PROFILE_HOLONOMIC_INPUT,  //HolonomicDrive::takeInput()
+  PROFILE_SCHEDULER_TICK,   //all jobs run in one Scheduler tick
+  PROFILE_USER              //first id returned by add()
+};
+
+struct ProfileStats {
+  const char *name;
+  unsigned long runs, overruns;
+  unsigned long minTime, maxTime, totalTime;  //execution time (microseconds)
+  unsigned long minPeriod, maxPeriod;         //time (microseconds) between starts of successive runs
+  unsigned long histogram[PROFILE_BUCKETS];
+};
+
+class Profiler {
+  public:
+    static char add(const char *name, unsigned long deadline=0);
+    /* Registers a profile for user code and returns its id, or -1 if
+      MAX_PROFILES profiles are already registered. A deadline of 0 uses the
+      loop period. */
+    static void record(char id, unsigned long start, unsigned long elapsed); //start and elapsed in microseconds
+    static void setLoopPeriod(unsigned short period);         //milliseconds (default 20)
+    static void setDeadline(char id, unsigned long deadline); //microseconds (0 to use the loop period)
+    static unsigned long getDeadline(char id);
+    //statistics
+    static bool getStats(char id, ProfileStats &stats);  //returns false if id is not registered
+    static void resetStats();
+    static void printStats();                 //prints a table of statistics of every profile which has run to stdout
+    static void printStats(FILE *lcdPort, char id);
+    /* Shows one profile on an LCD: its name and overruns on the first line,
+      mean and maximum time on the second */
+  private:
+    static ProfileStats profiles[MAX_PROFILES];
+    static unsigned long deadlines[MAX_PROFILES]; //0 for profiles using the loop period
+    static unsigned long loopPeriod;              //microseconds
+    static unsigned long lastStart[MAX_PROFILES];
+    static unsigned char numProfiles;
+};
+
+class ProfileScope { //records the time between its construction and destruction
+  public:
+    ProfileScope(char id) : id(id), start(micros()) {}
+    ~ProfileScope() { Profiler::record(id, start, micros() - start); }
+  private:
+    char id;
+    unsigned long start;
+};
+
+#ifdef PROFILING
+  #define PROFILE_JOIN(a, b) a##b
+  #define PROFILE_NAME(line) PROFILE_JOIN(profileScope, line)
+  #define PROFILE_SCOPE(id) ProfileScope PROFILE_NAME(__LINE__)(id)
+#else
+  #define PROFILE_SCOPE(id) ((void)0)
+#endif
+
+#endif
@@ -9,10 +9,10 @@
 
 class QuadRamp : public Ramper {
   public:
-    double evaluate(double input);
-    QuadRamp(float target, float initial, float maximum, float end);
+    real_t evaluate(real_t input);
+    QuadRamp(real_t target, real_t initial, real_t maximum, real_t end);
   private:
-    double a, b, c; //coefficients of ramping equation
+    real_t a, b, c; //coefficients of ramping equation
 };
 
 #endif
@@ -3,9 +3,11 @@
 #ifndef RAMPER_INCLUDED
 #define RAMPER_INCLUDED
 
+#include "coreIncludes.h" //for real_t
+
 class Ramper {
   public:
-    virtual double evaluate(double input);
+    virtual real_t evaluate(real_t input) = 0;
 };
 
 #endif
@@ -0,0 +1,21 @@
+/* Lookup table mapping joystick axis values to motor powers
+
+  The curve (power = coeff * 127 * (|input|/127)^powMap, with the sign of
+  input) is evaluated once for each of the 256 possible axis values when it
+  is configured, so mapping an input is a single indexed load. Outputs are
+  limited to [-127, 127], and outputs smaller in magnitude than deadband are
+  set to 0. */
+
+#ifndef RESPONSE_CURVE_INCLUDED
+#define RESPONSE_CURVE_INCLUDED
+
+class ResponseCurve {
+  public:
+    void configure(double coeff=1, double powMap=1, unsigned char deadband=0);
+    char map(char input) { return table[(unsigned char)input]; }
+    ResponseCurve(double coeff=1, double powMap=1, unsigned char deadband=0);
+  private:
+    signed char table[256]; //indexed by input reinterpreted as unsigned
+};
+
+#endif
@@ -0,0 +1,47 @@
+/* Runs registered control jobs (e.g. ParallelDrive::executeManeuver()) at fixed
+  rates in a background task
+
+  Jobs run in order of registration from a single task which wakes every
+  tickPeriod milliseconds (using taskDelayUntil()) and refreshes the
+  SensorCache (if active) before running the jobs which are due. Job periods
+  should therefore be multiples of tickPeriod. Execution time and start-time
+  jitter (relative to when the job was due) are recorded for every job. */
+
+#ifndef SCHEDULER_INCLUDED
+#define SCHEDULER_INCLUDED
+
+#include <API.h>
+
+#define MAX_JOBS 12
+
+typedef void (*JobFunction)(void *object);
+
+struct JobStats {
+  unsigned long runs;
+  unsigned long missed;                         //number of times job was late by a full period or more (those runs are skipped)
+  unsigned long minTime, maxTime, totalTime;    //execution time (microseconds)
+  unsigned long maxJitter, totalJitter;         //time (milliseconds, the resolution of job scheduling) between when job was due and when it started
+};
+
+class Scheduler {
+  public:
+    static char add(JobFunction job, void *object, unsigned short period);
+    /* Registers job to be called with object every period milliseconds.
+      Returns an id for use with the functions below, or -1 if MAX_JOBS jobs
+      are already registered. */
+    static void remove(char id);
+    static bool start(unsigned short tickPeriod=5, unsigned int priority=TASK_PRIORITY_DEFAULT+1); //starts background task. Returns false if it could not be created
+    static void stop();
+    static bool isRunning();
+    static unsigned short getTickPeriod();
+    //statistics
+    static bool getStats(char id, JobStats &stats); //returns false if id is not registered
+    static void resetStats();
+    static void printStats();                       //prints a table of statistics of all jobs to stdout
+  private:
+    static void run(void *ignore);
+    static TaskHandle task;
+    static unsigned short tickPeriod;
+};
+
+#endif
@@ -0,0 +1,64 @@
+/* Samples every registered sensor and joystick input once per control cycle,
+  so that all subsystems read a consistent state without repeating API calls
+
+  Library classes register the sensors and inputs they use automatically. The
+  cache becomes active the first time update() is called; from then on,
+  reads of registered inputs return the values from the latest update(), so
+  update() should be called once at the start of every control loop
+  iteration. Until then (and for unregistered inputs), values are read
+  directly. Each sample also sets the time read by every TickTimer.
+
+  Once the Scheduler is running, samples are taken both by its task and by
+  the task calling update(), so every write to the snapshot (and the tick
+  time) is made while holding a mutex. The Scheduler task has the higher
+  priority, so its jobs never run while another task is part way through
+  a sample. */
+
+#ifndef SENSOR_CACHE_INCLUDED
+#define SENSOR_CACHE_INCLUDED
+
+#include <API.h>
+
+#define CACHE_NUM_JOYSTICKS 2
+#define CACHE_NUM_ENCODER_PORTS 12
+
+struct SensorSnapshot {
+  unsigned long time;                                   //millis() when snapshot was taken
+  int encoders[CACHE_NUM_ENCODER_PORTS];                //encoder counts, indexed by top port - 1
+  int analog[BOARD_NR_ADC_PINS];                        //analogRead() or gyroGet() value, indexed by port - 1
+  signed char axes[CACHE_NUM_JOYSTICKS][6];             //joystick axes, indexed by [joystick-1][axis-1]
+};
+
+class SensorCache {
+  public:
+    static void update();   //samples every registered input, updates ButtonTracker and InputRecorder, and activates the cache
+    static void refresh();  //resamples sensors and axes only if the cache is active (used by blocking library functions)
+    static bool isActive();
+    static const SensorSnapshot& snapshot();
+    static void enableLocking();  //creates the mutex guarding samples (called by Scheduler::start())
+    //registration
+    static void addEncoder(unsigned char topPort, Encoder encoder);
+    static void addGyro(unsigned char port, Gyro gyro);
+    static void resetGyro(unsigned char port);  //resets registered gyro and its cached value
+    static void addAnalog(unsigned char port);
+    static void addJoystickAxis(unsigned char axis, unsigned char joystick=1);
+    //values
+    static int encoder(unsigned char topPort);  //returns 0 if no encoder is registered on topPort
+    static int gyro(unsigned char port);        //returns 0 if no gyro is registered on port
+    static int analog(unsigned char port);
+    static int joystickAnalog(unsigned char axis, unsigned char joystick=1);
+  private:
+    static void sample();
+    static void lock();   //do nothing until enableLocking() is called
+    static void unlock();
+    static SensorSnapshot values;
+    static bool active;
+    static Mutex writeLock;
+    static Encoder encoderHandles[CACHE_NUM_ENCODER_PORTS];
+    static Gyro gyroHandles[BOARD_NR_ADC_PINS];
+    static unsigned short encoderMask;                      //bit (port-1) set if an encoder's top port is port
+    static unsigned char gyroMask, analogMask;              //bit (port-1) set if a gyro/potentiometer is attached to port
+    static unsigned char axisMask[CACHE_NUM_JOYSTICKS];     //bit (axis-1) set if axis is registered
+};
+
+#endif
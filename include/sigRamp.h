@@ -10,10 +10,10 @@
 
 class SigRamp : public Ramper {
   public:
-    double evaluate(double input);
-    SigRamp(double k=0.0005, double M=127, double intercept=10);
+    real_t evaluate(real_t input);
+    SigRamp(real_t k=0.0005, real_t M=127, real_t intercept=10);
   private:
-    double k, M2, i, C, s;  //tuning constants in logistic equation
+    real_t k, M2, i, C, s;  //tuning constants in logistic equation
 };
 
 #endif
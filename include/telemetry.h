@@ -0,0 +1,111 @@
+/* Buffers timestamped binary records of control state and streams them to a
+  serial port from a low-priority task
+
+  Record sites use TELEMETRY_LOG(level, type, source, a, b, c) (or
+  TELEMETRY_COUNTS for integer values), which expands to nothing unless
+  TELEMETRY_LEVEL (set in common.mk) is at least level, so disabled sites cost
+  no code or time. Levels used by the library:
+    1: robot pose after every odometry update
+    2: odometry deltas and controller target/measurement/output each cycle
+    3: every motor power set
+
+  log() is safe to call from any task: it claims a slot of a fixed-size ring
+  buffer with a compare-and-swap and never blocks or allocates. Records which
+  do not fit are dropped and counted. The task started by start() drains the
+  buffer to the serial port. At 115200 baud it can send about 500 records per
+  second. Frames begin with two sync bytes which cannot occur in ASCII text,
+  so printf() output may share the port; tools/telemetryDecoder.cpp (built
+  with `make decoder`) skips that text and converts the frames to CSV.
+
+  Frame format (21 bytes, multi-byte fields little-endian):
+    0xA5 0x5A           sync
+    type                TelemetryType, with TELEMETRY_INTEGER (0x80) set if
+                        values are signed 32-bit integers instead of floats
+    source              subsystem which logged the record (library classes
+                        use the port of their first motor)
+    time                32-bit micros() when the record was logged
+    values              three 32-bit floats or integers
+    checksum            sum of the bytes from type to the end of values */
+
+#ifndef TELEMETRY_INCLUDED
+#define TELEMETRY_INCLUDED
+
+#include <API.h>
+
+#ifndef TELEMETRY_LEVEL
+#define TELEMETRY_LEVEL 0 //0 disables telemetry, higher levels record increasingly detailed state
+#endif
+
+#ifndef TELEMETRY_BUFFER_SIZE
+#define TELEMETRY_BUFFER_SIZE 64  //records buffered in RAM (must be a power of 2)
+#endif
+
+#define TELEMETRY_FRAME_SIZE 21
+#define TELEMETRY_INTEGER 0x80
+
+enum TelemetryType {
+  TELEMETRY_POSE = 1,         //x (inches), y (inches), orientation (degrees)
+  TELEMETRY_ODOMETRY,         //left distance, right distance (inches) since last update
+  TELEMETRY_CONTROLLER,       //target, measured value, output
+  TELEMETRY_MOTORS,           //power (integer)
+  TELEMETRY_EVENT,            //user-defined values (integer)
+  TELEMETRY_USER = 0x10       //first type available to user code
+};
+
+struct TelemetryRecord {
+  unsigned long time;
+  unsigned char type, source;
+  volatile bool ready;  //set once the record is completely written
+  union {
+    float real[3];
+    long integer[3];
+  } values;
+};
+
+class Telemetry {
+  public:
+    static bool start(FILE *port=stdout, unsigned int priority=TASK_PRIORITY_LOWEST+1);
+    /* Starts the task which drains the buffer to port every 10 milliseconds.
+      Returns false if the task could not be created or TELEMETRY_LEVEL is 0. */
+    static void stop();
+    static bool isRunning();
+    static void log(unsigned char type, unsigned char source, float a, float b=0, float c=0);
+    static void logCounts(unsigned char type, unsigned char source, long a, long b=0, long c=0);
+    static void flush();              //sends every buffered record from the calling task (only one task may flush at a time)
+    static unsigned int pending();    //number of records waiting to be sent
+    static unsigned long dropped();   //number of records lost because the buffer was full
+  private:
+    static void run(void *ignore);
+    static TelemetryRecord* claim(unsigned char type, unsigned char source);
+    static void send(const TelemetryRecord &record);
+    static TelemetryRecord buffer[TELEMETRY_BUFFER_SIZE];
+    static unsigned int head, tail;   //records claimed and records sent (never wrapped to buffer size)
+    static unsigned long droppedCount;
+    static FILE *port;
+    static TaskHandle task;
+};
+
+//#region record sites
+#define TELEMETRY_LOG(level, ...) TELEMETRY_LOG_##level(Telemetry::log, __VA_ARGS__)
+#define TELEMETRY_COUNTS(level, ...) TELEMETRY_LOG_##level(Telemetry::logCounts, __VA_ARGS__)
+
+#if TELEMETRY_LEVEL >= 1
+  #define TELEMETRY_LOG_1(function, ...) function(__VA_ARGS__)
+#else
+  #define TELEMETRY_LOG_1(function, ...) ((void)0)
+#endif
+
+#if TELEMETRY_LEVEL >= 2
+  #define TELEMETRY_LOG_2(function, ...) function(__VA_ARGS__)
+#else
+  #define TELEMETRY_LOG_2(function, ...) ((void)0)
+#endif
+
+#if TELEMETRY_LEVEL >= 3
+  #define TELEMETRY_LOG_3(function, ...) function(__VA_ARGS__)
+#else
+  #define TELEMETRY_LOG_3(function, ...) ((void)0)
+#endif
+//#endregion
+
+#endif
@@ -1,3 +1,13 @@
+/* Timers measuring time since their last reset
+
+  Timer reads millis() on every call. TickTimer has microsecond resolution
+  and reads the time of the current control cycle instead of the system
+  clock: SensorCache calls tick() whenever it samples, so while the cache is
+  active every TickTimer (PID sample timers, maneuver timers, etc.) sees the
+  same timestamp for the whole cycle, and intervals measured by different
+  controllers agree exactly. Until the cache is active, TickTimer falls back
+  to micros(). TickTimer times wrap after about 71 minutes. */
+
 #ifndef TIMER_INCLUDED
 #define TIMER_INCLUDED
 
@@ -10,4 +20,18 @@ class Timer {
     unsigned long lastReset;  //system time at last reset
 };
 
+class TickTimer {
+  public:
+    void reset();               //resets time to 0
+    unsigned long time();       //returns time since last reset (or created) in milliseconds
+    unsigned long timeMicros(); //returns time since last reset (or created) in microseconds
+    TickTimer();
+    static void tick();         //sets the time of the current control cycle to micros()
+    static unsigned long now(); //returns time (microseconds) of the current control cycle
+  private:
+    unsigned long lastReset;  //now() at last reset
+    static unsigned long tickTime;
+    static bool ticking;      //whether tick() has been called
+};
+
 #endif
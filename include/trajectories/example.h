@@ -0,0 +1,116 @@
+/* Generated by tools/trajectoryGenerator.cpp - edit the path file and run
+  `make trajectories` instead of modifying this file
+
+  99 samples, 98.0 inches, 7.66 seconds */
+
+#ifndef EXAMPLEPATH_TRAJECTORY_INCLUDED
+#define EXAMPLEPATH_TRAJECTORY_INCLUDED
+
+#include "trajectory.h"
+
+constexpr TrajectorySample examplePathSamples[] = {
+  //x, y, heading, velocity, curvature, time
+  { 0.000f, 0.000f, 0.00000f, 0.000f, 0.00000f, 0.0000f },
+  { 1.000f, 0.000f, 0.00000f, 6.325f, 0.00000f, 0.3162f },
+  { 2.000f, 0.000f, 0.00000f, 8.944f, 0.00000f, 0.4472f },
+  { 3.000f, 0.000f, 0.00000f, 10.954f, 0.00000f, 0.5477f },
+  { 4.000f, 0.000f, 0.00000f, 12.649f, 0.00000f, 0.6325f },
+  { 5.000f, 0.000f, 0.00000f, 14.142f, 0.00000f, 0.7071f },
+  { 6.000f, 0.000f, 0.00000f, 15.492f, 0.00000f, 0.7746f },
+  { 7.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 0.8381f },
+  { 8.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 0.9006f },
+  { 9.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 0.9631f },
+  { 10.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.0256f },
+  { 11.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.0881f },
+  { 12.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.1506f },
+  { 13.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.2131f },
+  { 14.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.2756f },
+  { 15.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.3381f },
+  { 16.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.4006f },
+  { 17.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.4631f },
+  { 18.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.5256f },
+  { 19.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.5881f },
+  { 20.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.6506f },
+  { 21.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.7131f },
+  { 22.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.7756f },
+  { 23.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.8381f },
+  { 24.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.9006f },
+  { 25.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 1.9631f },
+  { 26.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 2.0256f },
+  { 27.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 2.0881f },
+  { 28.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 2.1506f },
+  { 29.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 2.2131f },
+  { 30.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 2.2756f },
+  { 31.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 2.3381f },
+  { 32.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 2.4006f },
+  { 33.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 2.4631f },
+  { 34.000f, 0.000f, 0.00000f, 16.000f, 0.00000f, 2.5256f },
+  { 35.000f, 0.000f, 0.00000f, 15.312f, 0.00000f, 2.5895f },
+  { 36.000f, 0.000f, 0.00000f, 13.945f, 0.00000f, 2.6578f },
+  { 37.000f, 0.019f, 0.03772f, 12.428f, 0.03832f, 2.7337f },
+  { 37.998f, 0.076f, 0.07641f, 12.385f, 0.03891f, 2.8143f },
+  { 38.993f, 0.172f, 0.11526f, 12.346f, 0.03946f, 2.8951f },
+  { 39.984f, 0.307f, 0.15504f, 12.310f, 0.03997f, 2.9762f },
+  { 40.969f, 0.482f, 0.19573f, 12.276f, 0.04045f, 3.0576f },
+  { 41.945f, 0.697f, 0.23573f, 12.246f, 0.04087f, 3.1391f },
+  { 42.912f, 0.951f, 0.27739f, 12.219f, 0.04126f, 3.2209f },
+  { 43.868f, 1.245f, 0.31832f, 12.195f, 0.04161f, 3.3028f },
+  { 44.811f, 1.578f, 0.36009f, 12.173f, 0.04191f, 3.3849f },
+  { 45.739f, 1.950f, 0.40268f, 12.154f, 0.04219f, 3.4671f },
+  { 46.650f, 2.362f, 0.44451f, 12.139f, 0.04242f, 3.5494f },
+  { 47.543f, 2.811f, 0.48713f, 12.125f, 0.04261f, 3.6318f },
+  { 48.417f, 3.298f, 0.52975f, 12.113f, 0.04278f, 3.7143f },
+  { 49.268f, 3.823f, 0.57317f, 12.104f, 0.04292f, 3.7969f },
+  { 50.096f, 4.383f, 0.61578f, 12.097f, 0.04303f, 3.8795f },
+  { 50.900f, 4.978f, 0.65918f, 12.091f, 0.04311f, 3.9622f },
+  { 51.677f, 5.607f, 0.70178f, 12.087f, 0.04316f, 4.0449f },
+  { 52.426f, 6.270f, 0.74517f, 12.085f, 0.04320f, 4.1277f },
+  { 53.146f, 6.964f, 0.78855f, 12.084f, 0.04321f, 4.2104f },
+  { 53.835f, 7.688f, 0.83194f, 12.085f, 0.04319f, 4.2932f },
+  { 54.492f, 8.442f, 0.87454f, 12.087f, 0.04316f, 4.3759f },
+  { 55.117f, 9.223f, 0.91793f, 12.092f, 0.04310f, 4.4586f },
+  { 55.706f, 10.030f, 0.96054f, 12.097f, 0.04301f, 4.5413f },
+  { 56.261f, 10.862f, 1.00394f, 12.105f, 0.04290f, 4.6239f },
+  { 56.780f, 11.717f, 1.04657f, 12.115f, 0.04276f, 4.7065f },
+  { 57.261f, 12.594f, 1.08919f, 12.126f, 0.04259f, 4.7890f },
+  { 57.705f, 13.490f, 1.13181f, 12.140f, 0.04239f, 4.8714f },
+  { 58.110f, 14.404f, 1.17442f, 12.157f, 0.04215f, 4.9537f },
+  { 58.476f, 15.334f, 1.21622f, 12.176f, 0.04188f, 5.0359f },
+  { 58.804f, 16.279f, 1.25799f, 12.198f, 0.04156f, 5.1179f },
+  { 59.091f, 17.237f, 1.29891f, 12.222f, 0.04122f, 5.1998f },
+  { 59.339f, 18.206f, 1.34056f, 12.250f, 0.04082f, 5.2816f },
+  { 59.547f, 19.184f, 1.38055f, 12.280f, 0.04039f, 5.3631f },
+  { 59.716f, 20.169f, 1.42122f, 12.314f, 0.03991f, 5.4444f },
+  { 59.845f, 21.161f, 1.46098f, 12.351f, 0.03939f, 5.5255f },
+  { 59.935f, 22.157f, 1.49981f, 12.391f, 0.03883f, 5.6063f },
+  { 59.986f, 23.155f, 1.53847f, 12.434f, 0.03824f, 5.6869f },
+  { 60.000f, 24.155f, 1.57080f, 13.950f, 0.00000f, 5.7627f },
+  { 60.000f, 25.155f, 1.57080f, 15.317f, 0.00000f, 5.8310f },
+  { 60.000f, 26.155f, 1.57080f, 16.000f, 0.00000f, 5.8949f },
+  { 60.000f, 27.155f, 1.57080f, 16.000f, 0.00000f, 5.9574f },
+  { 60.000f, 28.155f, 1.57080f, 16.000f, 0.00000f, 6.0199f },
+  { 60.000f, 29.155f, 1.57080f, 16.000f, 0.00000f, 6.0824f },
+  { 60.000f, 30.155f, 1.57080f, 16.000f, 0.00000f, 6.1449f },
+  { 60.000f, 31.155f, 1.57080f, 16.000f, 0.00000f, 6.2074f },
+  { 60.000f, 32.155f, 1.57080f, 16.000f, 0.00000f, 6.2699f },
+  { 60.000f, 33.155f, 1.57080f, 16.000f, 0.00000f, 6.3324f },
+  { 60.000f, 34.155f, 1.57080f, 16.000f, 0.00000f, 6.3949f },
+  { 60.000f, 35.155f, 1.57080f, 16.000f, 0.00000f, 6.4574f },
+  { 60.000f, 36.155f, 1.57080f, 16.000f, -0.00000f, 6.5199f },
+  { 60.000f, 37.155f, 1.57080f, 16.000f, -0.00000f, 6.5824f },
+  { 60.000f, 38.155f, 1.57080f, 16.000f, -0.00000f, 6.6449f },
+  { 60.000f, 39.155f, 1.57080f, 16.000f, -0.00000f, 6.7074f },
+  { 60.000f, 40.155f, 1.57080f, 16.000f, -0.00000f, 6.7699f },
+  { 60.000f, 41.155f, 1.57080f, 16.000f, -0.00000f, 6.8324f },
+  { 60.000f, 42.155f, 1.57080f, 15.290f, -0.00000f, 6.8963f },
+  { 60.000f, 43.155f, 1.57080f, 13.921f, -0.00000f, 6.9647f },
+  { 60.000f, 44.155f, 1.57080f, 12.401f, -0.00000f, 7.0407f },
+  { 60.000f, 45.155f, 1.57080f, 10.668f, -0.00000f, 7.1274f },
+  { 60.000f, 46.155f, 1.57080f, 8.590f, -0.00000f, 7.2313f },
+  { 60.000f, 47.155f, 1.57080f, 5.813f, -0.00000f, 7.3701f },
+  { 60.000f, 48.000f, 1.57080f, 0.000f, -0.00000f, 7.6608f },
+};
+
+constexpr Trajectory examplePath = { examplePathSamples, 99, 1.000f };
+
+#endif
@@ -0,0 +1,24 @@
+/* Sample tables produced offline by tools/trajectoryGenerator.cpp (run with
+  `make trajectories`) and followed by ParallelDrive::followTrajectory()
+
+  Generated tables are constexpr, so they are placed in flash rather than RAM.
+  Samples are evenly spaced by distance along the path. */
+
+#ifndef TRAJECTORY_INCLUDED
+#define TRAJECTORY_INCLUDED
+
+struct TrajectorySample {
+  float x, y;       //inches, in the same frame as ParallelDrive::x() and y()
+  float heading;    //radians, counterclockwise from +x
+  float velocity;   //inches per second
+  float curvature;  //1/inches, positive to the left
+  float time;       //seconds from start of trajectory
+};
+
+struct Trajectory {
+  const TrajectorySample *samples;
+  unsigned short numSamples;
+  float spacing;    //distance (inches) between consecutive samples
+};
+
+#endif
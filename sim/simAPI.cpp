@@ -0,0 +1,492 @@
+/* Implementation of the PROS API (API.h) on top of the host-side simulation
+
+  Functions which the host C library already provides with compatible
+  signatures (printf, puts, snprintf, fopen, etc.) are not redefined, so
+  output written to stdout appears on the host's terminal. The other PROS
+  streams (uart1, uart2 and files) are not simulated. */
+
+#include <API.h>
+#include "simulation.h"
+
+extern "C" int vsnprintf(char *buffer, size_t limit, const char *formatString, va_list args);  //not declared by API.h
+
+#define SIM_MAX_SENSORS 12
+
+struct SimEncoder {
+  unsigned char topPort;
+  bool reversed, used;
+  int offset;
+};
+
+struct SimGyro {
+  unsigned char port;
+  unsigned short multiplier;
+  bool used;
+  int offset;
+};
+
+struct SimUltrasonic {
+  unsigned char echoPort;
+  bool used;
+};
+
+struct SimMutex {
+  void *owner;
+  bool taken, used;
+};
+
+struct SimLoop {
+  void (*fn)(void);
+  unsigned long increment;
+};
+
+static SimEncoder encoders[SIM_MAX_SENSORS];
+static SimGyro gyros[SIM_MAX_SENSORS];
+static SimUltrasonic ultrasonics[SIM_MAX_SENSORS];
+static SimMutex mutexes[TASK_MAX * 2];
+static SimLoop loops[TASK_MAX];
+static int analogCalibrations[BOARD_NR_ADC_PINS + 1];
+static char lcdText[2][2][17];
+
+extern "C" void __libc_init_array() {}
+/* Called by initializeIO() to run static constructors on the Cortex. The host's
+  runtime has already run them by the time main() is called. */
+
+static void charge() {
+  simAdvance(simGetConfig().apiCallCost);
+}
+
+//#region competition
+bool isAutonomous() {
+  charge();
+  return simGetConfig().autonomous;
+}
+
+bool isEnabled() {
+  charge();
+  return simGetConfig().enabled;
+}
+
+bool isJoystickConnected(unsigned char joystick) {
+  charge();
+  return joystick == 1;
+}
+
+bool isOnline() {
+  charge();
+  return false;
+}
+
+int joystickGetAnalog(unsigned char joystick, unsigned char axis) {
+  charge();
+  return simGetJoystickAnalog(joystick, axis);
+}
+
+bool joystickGetDigital(unsigned char joystick, unsigned char buttonGroup, unsigned char button) {
+  charge();
+  return simGetJoystickDigital(joystick, buttonGroup, button);
+}
+
+unsigned int powerLevelBackup() {
+  charge();
+  return 0;
+}
+
+unsigned int powerLevelMain() {
+  charge();
+  return 7800;
+}
+
+void setTeamName(const char *name) {}
+//#endregion
+
+//#region I/O
+int analogCalibrate(unsigned char channel) {
+  charge();
+  if (channel == 0 || channel > BOARD_NR_ADC_PINS) return 0;
+
+  analogCalibrations[channel] = simPotValue(channel);
+  return analogCalibrations[channel];
+}
+
+int analogRead(unsigned char channel) {
+  charge();
+  return simPotValue(channel);
+}
+
+int analogReadCalibrated(unsigned char channel) {
+  charge();
+  if (channel == 0 || channel > BOARD_NR_ADC_PINS) return 0;
+
+  return simPotValue(channel) - analogCalibrations[channel];
+}
+
+int analogReadCalibratedHR(unsigned char channel) {
+  return analogReadCalibrated(channel) * 16;
+}
+
+bool digitalRead(unsigned char pin) {
+  charge();
+  return simGetDigital(pin);
+}
+
+void digitalWrite(unsigned char pin, bool value) {
+  charge();
+  simSetDigital(pin, value);
+}
+
+void pinMode(unsigned char pin, unsigned char mode) { charge(); }
+
+void ioClearInterrupt(unsigned char pin) { charge(); }
+void ioSetInterrupt(unsigned char pin, unsigned char edges, InterruptHandler handler) { charge(); } //interrupts are never raised
+//#endregion
+
+//#region motors
+int motorGet(unsigned char channel) {
+  charge();
+  return simGetMotor(channel);
+}
+
+void motorSet(unsigned char channel, int speed) {
+  charge();
+  simSetMotor(channel, speed);
+}
+
+void motorStop(unsigned char channel) {
+  motorSet(channel, 0);
+}
+
+void motorStopAll() {
+  for (unsigned char channel=1; channel<=10; channel++)
+    simSetMotor(channel, 0);
+
+  charge();
+}
+//#endregion
+
+//#region speaker
+void speakerInit() {}
+void speakerPlayArray(const char * * songs) {}
+void speakerPlayRtttl(const char *song) {}
+void speakerShutdown() {}
+//#endregion
+
+//#region sensors
+  //#subregion integrated motor encoders (not simulated)
+unsigned int imeInitializeAll() {
+  charge();
+  return 0;
+}
+
+bool imeGet(unsigned char address, int *value) {
+  charge();
+  return false;
+}
+
+bool imeGetVelocity(unsigned char address, int *value) {
+  charge();
+  return false;
+}
+
+bool imeReset(unsigned char address) {
+  charge();
+  return false;
+}
+
+void imeShutdown() {}
+  //#endsubregion
+
+  //#subregion gyro
+int gyroGet(Gyro gyro) {
+  charge();
+  SimGyro *g = static_cast<SimGyro*>(gyro);
+  if (!g) return 0;
+
+  return (simGyroDegrees() - g->offset) * g->multiplier / 196;
+}
+
+Gyro gyroInit(unsigned char port, unsigned short multiplier) {
+  charge();
+  if (port == 0 || port > BOARD_NR_ADC_PINS || port != simGetConfig().drive.gyroPort) return NULL;
+
+  for (unsigned char i=0; i<SIM_MAX_SENSORS; i++) {
+    if (!gyros[i].used) {
+      gyros[i].port = port;
+      gyros[i].multiplier = (multiplier==0 ? 196 : multiplier);
+      gyros[i].offset = simGyroDegrees();
+      gyros[i].used = true;
+      return &gyros[i];
+    }
+  }
+
+  return NULL;
+}
+
+void gyroReset(Gyro gyro) {
+  charge();
+  SimGyro *g = static_cast<SimGyro*>(gyro);
+  if (g) g->offset = simGyroDegrees();
+}
+
+void gyroShutdown(Gyro gyro) {
+  SimGyro *g = static_cast<SimGyro*>(gyro);
+  if (g) g->used = false;
+}
+  //#endsubregion
+
+  //#subregion encoders
+int encoderGet(Encoder enc) {
+  charge();
+  SimEncoder *e = static_cast<SimEncoder*>(enc);
+  if (!e) return 0;
+
+  return (simEncoderTicks(e->topPort) - e->offset) * (e->reversed ? -1 : 1);
+}
+
+Encoder encoderInit(unsigned char portTop, unsigned char portBottom, bool reverse) {
+  charge();
+  if (portTop == 0 || portTop > BOARD_NR_GPIO_PINS) return NULL;
+
+  for (unsigned char i=0; i<SIM_MAX_SENSORS; i++) {
+    if (!encoders[i].used) {
+      encoders[i].topPort = portTop;
+      encoders[i].reversed = reverse;
+      encoders[i].offset = simEncoderTicks(portTop);
+      encoders[i].used = true;
+      return &encoders[i];
+    }
+  }
+
+  return NULL;
+}
+
+void encoderReset(Encoder enc) {
+  charge();
+  SimEncoder *e = static_cast<SimEncoder*>(enc);
+  if (e) e->offset = simEncoderTicks(e->topPort);
+}
+
+void encoderShutdown(Encoder enc) {
+  SimEncoder *e = static_cast<SimEncoder*>(enc);
+  if (e) e->used = false;
+}
+  //#endsubregion
+
+  //#subregion ultrasonics (not simulated)
+int ultrasonicGet(Ultrasonic ult) {
+  charge();
+  return -1;  //no echo received
+}
+
+Ultrasonic ultrasonicInit(unsigned char portEcho, unsigned char portPing) {
+  charge();
+
+  for (unsigned char i=0; i<SIM_MAX_SENSORS; i++) {
+    if (!ultrasonics[i].used) {
+      ultrasonics[i].echoPort = portEcho;
+      ultrasonics[i].used = true;
+      return &ultrasonics[i];
+    }
+  }
+
+  return NULL;
+}
+
+void ultrasonicShutdown(Ultrasonic ult) {
+  SimUltrasonic *u = static_cast<SimUltrasonic*>(ult);
+  if (u) u->used = false;
+}
+  //#endsubregion
+//#endregion
+
+//#region I2C (not simulated)
+bool i2cRead(uint8_t addr, uint8_t *data, uint16_t count) { return false; }
+bool i2cReadRegister(uint8_t addr, uint8_t reg, uint8_t *value, uint16_t count) { return false; }
+bool i2cWrite(uint8_t addr, uint8_t *data, uint16_t count) { return false; }
+bool i2cWriteRegister(uint8_t addr, uint8_t reg, uint16_t value) { return false; }
+//#endregion
+
+//#region serial and files
+void usartInit(FILE *usart, unsigned int baud, unsigned int flags) {}
+void usartShutdown(FILE *usart) {}
+
+int fcount(FILE *stream) { return 0; }
+int fdelete(const char *file) { return -1; }
+
+void fprint(const char *string, FILE *stream) {
+  if (stream == stdout) print(string);
+}
+
+void print(const char *string) {
+  printf("%s", string);
+}
+//#endregion
+
+//#region LCD
+void lcdClear(FILE *lcdPort) {
+  lcdSetText(lcdPort, 1, "");
+  lcdSetText(lcdPort, 2, "");
+}
+
+void lcdInit(FILE *lcdPort) {
+  lcdClear(lcdPort);
+}
+
+void lcdPrint(FILE *lcdPort, unsigned char line, const char *formatString, ...) {
+  char buffer[17];
+  va_list args;
+
+  va_start(args, formatString);
+  vsnprintf(buffer, sizeof(buffer), formatString, args);
+  va_end(args);
+
+  lcdSetText(lcdPort, line, buffer);
+}
+
+unsigned int lcdReadButtons(FILE *lcdPort) { return 0; }
+void lcdSetBacklight(FILE *lcdPort, bool backlight) {}
+
+void lcdSetText(FILE *lcdPort, unsigned char line, const char *buffer) {
+  if ((lcdPort != uart1 && lcdPort != uart2) || line < 1 || line > 2) return;
+
+  char *text = lcdText[lcdPort==uart2][line-1];
+  unsigned char i;
+
+  for (i=0; i<16 && buffer[i]; i++)
+    text[i] = buffer[i];
+  text[i] = '\0';
+}
+
+void lcdShutdown(FILE *lcdPort) {}
+//#endregion
+
+//#region tasks
+TaskHandle taskCreate(TaskCode taskCode, const unsigned int stackDepth, void *parameters, const unsigned int priority) {
+  return simTaskCreate(taskCode, parameters, priority);
+}
+
+void taskDelay(const unsigned long msToDelay) {
+  charge();
+
+  if (msToDelay == 0)
+    simYield();
+  else
+    simSleepUntil(simTime() + (uint64_t)msToDelay*1000);
+}
+
+void taskDelayUntil(unsigned long *previousWakeTime, const unsigned long cycleTime) {
+  charge();
+  *previousWakeTime += cycleTime;
+
+  if ((uint64_t)*previousWakeTime * 1000 > simTime())
+    simSleepUntil((uint64_t)*previousWakeTime * 1000);
+  else
+    simYield();
+}
+
+void taskDelete(TaskHandle taskToDelete) { simTaskDelete(taskToDelete); }
+unsigned int taskGetCount() { return simTaskCount(); }
+unsigned int taskGetState(TaskHandle task) { return simTaskState(task); }
+unsigned int taskPriorityGet(const TaskHandle task) { return simTaskPriority(task); }
+void taskPrioritySet(TaskHandle task, const unsigned int newPriority) { simSetTaskPriority(task, newPriority); }
+void taskResume(TaskHandle taskToResume) { simSuspendTask(taskToResume, false); }
+void taskSuspend(TaskHandle taskToSuspend) { simSuspendTask(taskToSuspend, true); }
+
+static void runLoop(void *parameters) {
+  SimLoop *loop = static_cast<SimLoop*>(parameters);
+  unsigned long wakeTime = millis();
+
+  while (true) {
+    loop->fn();
+    taskDelayUntil(&wakeTime, loop->increment);
+  }
+}
+
+TaskHandle taskRunLoop(void (*fn)(void), const unsigned long increment) {
+  for (unsigned char i=0; i<TASK_MAX; i++) {
+    if (!loops[i].fn) {
+      loops[i].fn = fn;
+      loops[i].increment = increment;
+      return taskCreate(runLoop, TASK_DEFAULT_STACK_SIZE, &loops[i], TASK_PRIORITY_DEFAULT);
+    }
+  }
+
+  return NULL;
+}
+//#endregion
+
+//#region synchronization
+static SimMutex* createLock(bool taken) {
+  for (unsigned char i=0; i<TASK_MAX*2; i++) {
+    if (!mutexes[i].used) {
+      mutexes[i].used = true;
+      mutexes[i].taken = taken;
+      mutexes[i].owner = NULL;
+      return &mutexes[i];
+    }
+  }
+
+  return NULL;
+}
+
+static bool takeLock(void *lock, unsigned long blockTime) {
+  SimMutex *m = static_cast<SimMutex*>(lock);
+  if (!m) return false;
+
+  uint64_t deadline = simTime() + (uint64_t)blockTime*1000;
+  charge();
+
+  while (m->taken) {  //cooperative scheduling means the lock can only be freed by another task
+    if (blockTime != (unsigned long)-1 && simTime() >= deadline) return false;
+    simSleepUntil(simTime() + 1000);
+  }
+
+  m->taken = true;
+  m->owner = simCurrentTask();
+  return true;
+}
+
+static bool giveLock(void *lock) {
+  SimMutex *m = static_cast<SimMutex*>(lock);
+  if (!m || !m->taken) return false;
+
+  charge();
+  m->taken = false;
+  m->owner = NULL;
+  return true;
+}
+
+Semaphore semaphoreCreate() { return createLock(false); }
+bool semaphoreGive(Semaphore semaphore) { return giveLock(semaphore); }
+bool semaphoreTake(Semaphore semaphore, const unsigned long blockTime) { return takeLock(semaphore, blockTime); }
+void semaphoreDelete(Semaphore semaphore) { static_cast<SimMutex*>(semaphore)->used = false; }
+
+Mutex mutexCreate() { return createLock(false); }
+bool mutexGive(Mutex mutex) {
+  SimMutex *m = static_cast<SimMutex*>(mutex);
+  return (m && m->owner == simCurrentTask()) ? giveLock(mutex) : false;
+}
+bool mutexTake(Mutex mutex, const unsigned long blockTime) { return takeLock(mutex, blockTime); }
+void mutexDelete(Mutex mutex) { static_cast<SimMutex*>(mutex)->used = false; }
+//#endregion
+
+//#region time
+void delay(const unsigned long time) { taskDelay(time); }
+void wait(const unsigned long time) { taskDelay(time); }
+void waitUntil(unsigned long *previousWakeTime, const unsigned long time) { taskDelayUntil(previousWakeTime, time); }
+
+void delayMicroseconds(const unsigned long us) {
+  charge();
+  simAdvance(us); //busy-waits, like the real implementation does for short delays
+}
+
+unsigned long micros() {
+  charge();
+  return (uint32_t)simTime();  //32-bit like on the Cortex
+}
+
+unsigned long millis() {
+  charge();
+  return (uint32_t)(simTime() / 1000);
+}
+//#endregion
@@ -0,0 +1,43 @@
+/* Replacements for the global new and delete operators which keep track of
+  heap usage, so that allocations made by the library can be measured (and
+  reported by HeapGuard once it is locked) */
+
+#include "simulation.h"
+#include "heapGuard.h"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static SimHeapStats stats;
+
+//each block is prefixed with its size (padded to keep the block aligned)
+static const size_t HEADER_SIZE = alignof(std::max_align_t);
+
+SimHeapStats simHeapStats() { return stats; }
+
+void* operator new(size_t size) {
+  HeapGuard::allocated(size);
+
+  char *block = static_cast<char*>(malloc(size + HEADER_SIZE));
+  if (!block) abort();
+
+  *reinterpret_cast<size_t*>(block) = size;
+  stats.bytesInUse += size;
+  stats.allocations++;
+  if (stats.bytesInUse > stats.highWater) stats.highWater = stats.bytesInUse;
+
+  return block + HEADER_SIZE;
+}
+
+void operator delete(void *ptr) noexcept {
+  if (!ptr) return;
+
+  char *block = static_cast<char*>(ptr) - HEADER_SIZE;
+  stats.bytesInUse -= *reinterpret_cast<size_t*>(block);
+  free(block);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, size_t size) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t size) noexcept { operator delete(ptr); }
@@ -0,0 +1,98 @@
+/* Entry point of the host-side simulation (built with `make sim`)
+
+  Stands in for the PROS kernel: runs initializeIO(), initialize() and then
+  either autonomous() or operatorControl() in a task, for a fixed amount of
+  virtual time, or a self-checking scenario (see simScenarios.h), which runs
+  until it finishes unless -t is given.
+
+  Usage: simulator [auto|opcontrol|<scenario>] [-t <milliseconds>] [-v] */
+
+#include "main.h"
+#include "simulation.h"
+#include "simScenarios.h"
+#include "heapGuard.h"
+#include <cmath>
+#include <string.h>
+#include <time.h>
+
+static bool verbose;
+static const SimScenario *scenario;
+static int scenarioStatus;
+
+static void kernelTask(void *ignore) {
+  initializeIO();
+  initialize();
+
+  if (scenario) {
+    scenarioStatus = scenario->run();
+    simStop();  //background tasks never finish
+  } else if (isAutonomous()) {
+    autonomous();
+  } else {
+    operatorControl();
+  }
+}
+
+static void printPose() {
+  SimPose pose = simGetPose();
+  printf("%8.3f s  x=%7.2f in  y=%7.2f in  theta=%7.2f deg  slip L/R=%5.2f/%5.2f in/s\n",
+         simTime()/1e6, pose.x, pose.y, pose.theta*180/acos(-1), pose.leftSlip, pose.rightSlip);
+}
+
+static void monitorTask(void *ignore) {
+  while (true) {
+    printPose();
+    simSleepUntil(simTime() + 100000);
+  }
+}
+
+static double wallSeconds() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec + now.tv_nsec/1e9;
+}
+
+int main(int argc, char *argv[]) {
+  SimConfig config;
+  simDefaultConfig(config);
+  bool durationSet = false;
+
+  for (int i=1; i<argc; i++) {
+    if (strcmp(argv[i], "auto") == 0) {
+      config.autonomous = true;
+    } else if (strcmp(argv[i], "opcontrol") == 0) {
+      config.autonomous = false;
+    } else if (strcmp(argv[i], "-t") == 0 && i+1 < argc) {
+      config.duration = strtoul(argv[++i], NULL, 10);
+      durationSet = true;
+    } else if (strcmp(argv[i], "-v") == 0) {
+      verbose = true;
+    } else if (simFindScenario(argv[i])) {
+      scenario = simFindScenario(argv[i]);
+    } else {
+      printf("Usage: %s [auto|opcontrol|<scenario>] [-t <milliseconds>] [-v]\nScenarios:\n", argv[0]);
+      simListScenarios();
+      return 1;
+    }
+  }
+
+  if (scenario && !durationSet) config.duration = 0;
+
+  simConfigure(config);
+  simTaskCreate(kernelTask, NULL, TASK_PRIORITY_DEFAULT);
+  if (verbose) simTaskCreate(monitorTask, NULL, TASK_PRIORITY_HIGHEST);
+
+  double start = wallSeconds();
+  simRun();
+  double elapsed = wallSeconds() - start;
+
+  printPose();
+  printf("Simulated %.3f s in %.3f s (%.0fx real time), %lu API calls\n",
+         simTime()/1e6, elapsed, simTime()/1e6/elapsed, simApiCalls());
+
+  SimHeapStats heap = simHeapStats();
+  printf("Heap: %lu bytes in use, %lu byte high-water mark, %lu allocations (%u after startup)\n",
+         heap.bytesInUse, heap.highWater, heap.allocations, HeapGuard::violations());
+  if (HeapGuard::violations()) return 2;
+  return scenarioStatus;
+}
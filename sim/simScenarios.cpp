@@ -0,0 +1,528 @@
+#include "simScenarios.h"
+#include "simulation.h"
+#include "config.h" //also includes parallelDrive and API
+#include "heapGuard.h"
+#include "sensorCache.h"
+#include "PIDBank.h"
+#include "PID.h"
+#include "quadRamp.h"
+#include "sigRamp.h"
+#include "fixedPID.h"
+#include "fixedQuadRamp.h"
+#include "fixedSigRamp.h"
+#include "responseCurve.h"
+#include "binaryAngle.h"
+#include <cmath>
+#include <string.h>
+#include <time.h>
+
+static double wallNanoseconds() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec*1e9 + now.tv_nsec;
+}
+
+static bool check(const char *quantity, double value, double bound) {  //prints result of a check that value <= bound
+  bool passed = value <= bound;
+  printf("%-44s %-12g (bound %g) %s\n", quantity, value, bound, passed ? "ok" : "FAIL");
+  return passed;
+}
+
+static volatile real_t sink; //keeps benchmarked results from being optimized away
+
+static double nanosecondsPerCall(Ramper &ramp, real_t inputMax) {
+  /* Every call is preceded by TickTimer::tick(), so that PIDs see time pass
+    and evaluate each time, and the cost of a loop of ticks alone is
+    subtracted. The task runs at the highest priority meanwhile, so that no
+    other task runs during the virtual time the ticks consume. */
+  const unsigned int calls = 200000;
+  unsigned int priority = taskPriorityGet(NULL);
+  taskPrioritySet(NULL, TASK_PRIORITY_HIGHEST);
+
+  double start = wallNanoseconds();
+  for (unsigned int i=0; i<calls; i++) TickTimer::tick();
+  double tickTime = wallNanoseconds() - start;
+
+  start = wallNanoseconds();
+
+  for (unsigned int i=0; i<calls; i++) {
+    TickTimer::tick();
+    sink = ramp.evaluate(inputMax * (i%1000) / 1000);
+  }
+
+  double total = wallNanoseconds() - start;
+  taskPrioritySet(NULL, priority);
+  return (total - tickTime) / calls;
+}
+
+//#region maneuvers
+/* Starting a maneuver must not allocate, so heap use has to stay flat no
+  matter how many maneuvers are run */
+static int maneuvers() {
+  const unsigned int count = 1000;
+  unsigned long highWater = 0;
+
+  for (unsigned int i=0; i<count; i++) {
+    if (i%2 == 0)
+      drive.drive(12);
+    else
+      drive.turn(90, false, 40, 127, 20); //with the default final power (-30), the simulated robot stalls just short of the target
+
+    if (i == 0) highWater = simHeapStats().highWater;
+  }
+
+  SimHeapStats heap = simHeapStats();
+  printf("%u maneuvers: heap high-water mark %lu bytes after first, %lu bytes after last\n", count, highWater, heap.highWater);
+
+  bool passed = heap.highWater == highWater && HeapGuard::violations() == 0;
+  printf("%s\n", passed ? "PASS" : "FAIL: heap grew while running maneuvers");
+  return passed ? 0 : 1;
+}
+//#endregion
+
+//#region fixed-point controllers
+/* The fixed-point controllers are meant to be drop-in replacements, so over
+  the ranges their constructors are used with, their outputs must stay within
+  the bounds documented in their headers of the floating point versions' */
+static double quadRampError() {
+  const real_t targets[] = { 5, 12, 45, 90, 180, 360, 1000, 3000 };
+  const real_t initials[] = { 0, 20, 40, 60 };
+  const real_t maximums[] = { 80, 100, 127 };
+  const real_t ends[] = { -30, -10, 0, 20 };
+  double maxError = 0;
+
+  for (real_t target : targets) for (real_t initial : initials) for (real_t maximum : maximums) for (real_t end : ends) {
+    QuadRamp ramp(target, initial, maximum, end);
+    FixedQuadRamp fixedRamp(target, initial, maximum, end);
+
+    for (unsigned int i=0; i<=500; i++) {
+      real_t input = target * i / 500;
+      maxError = fmax(maxError, fabs(ramp.evaluate(input) - fixedRamp.evaluate(input)));
+    }
+  }
+
+  return maxError;
+}
+
+static double sigRampError() {
+  const real_t ks[] = { 0.0002, 0.0005, 0.001, 0.002 };
+  const real_t maximums[] = { 60, 100, 127 };
+  const real_t intercepts[] = { 5, 10, 30 };
+  double maxError = 0;
+
+  for (real_t k : ks) for (real_t maximum : maximums) for (real_t intercept : intercepts) {
+    SigRamp ramp(k, maximum, intercept);
+    FixedSigRamp fixedRamp(k, maximum, intercept);
+    real_t inputMax = 6 / (k * 2*maximum);  //six time constants of the logistic curve
+
+    for (unsigned int i=0; i<=500; i++) {
+      real_t input = inputMax * i / 500;
+      maxError = fmax(maxError, fabs(ramp.evaluate(input) - fixedRamp.evaluate(input)));
+    }
+  }
+
+  return maxError;
+}
+
+static double pidError() {  //both controllers drive their own copy of a first-order plant toward a step
+  const real_t kPs[] = { 0.1, 0.5, 2 };
+  const real_t kIs[] = { 0, 0.01, 0.05 };
+  const real_t kDs[] = { 0, 0.5, 2 };
+  const real_t targets[] = { 100, 2000 };
+  double maxError = 0;
+
+  for (real_t kP : kPs) for (real_t kI : kIs) for (real_t kD : kDs) for (real_t target : targets) {
+    PID pid(target, kP, kI, kD, 0, 50);
+    FixedPID fixedPID(target, kP, kI, kD, 0, 50);
+    pid.setOutputLimits(-127, 127);
+    fixedPID.setOutputLimits(-127, 127);
+    pid.setAntiWindup(CONDITIONAL_INTEGRATION);
+    fixedPID.setAntiWindup(CONDITIONAL_INTEGRATION);
+    real_t position = 0;
+
+    for (unsigned int i=0; i<300; i++) {
+      delay(1);
+      TickTimer::tick();
+
+      real_t output = pid.evaluate(position);
+      maxError = fmax(maxError, fabs(output - fixedPID.evaluate(position)));
+      position += output / 4;
+    }
+  }
+
+  return maxError;
+}
+
+static int fixedControl() {
+  bool passed = check("QuadRamp vs FixedQuadRamp max error", quadRampError(), 0.05);
+  passed = check("SigRamp vs FixedSigRamp max error", sigRampError(), 0.1) && passed;
+  passed = check("PID vs FixedPID max error", pidError(), 0.05) && passed;
+
+  QuadRamp quadRamp(1000, 40, 127, -30);
+  FixedQuadRamp fixedQuadRamp(1000, 40, 127, -30);
+  SigRamp sigRamp;
+  FixedSigRamp fixedSigRamp;
+  PID pid(1000, 0.5, 0.01, 0.5, 0);
+  FixedPID fixedPID(1000, 0.5, 0.01, 0.5, 0);
+
+  printf("\nns per evaluate() on this host (floating point / fixed point):\n");
+  printf("  QuadRamp %7.2f / %7.2f\n", nanosecondsPerCall(quadRamp, 1000), nanosecondsPerCall(fixedQuadRamp, 1000));
+  printf("  SigRamp  %7.2f / %7.2f\n", nanosecondsPerCall(sigRamp, 10000), nanosecondsPerCall(fixedSigRamp, 10000));
+  printf("  PID      %7.2f / %7.2f\n", nanosecondsPerCall(pid, 1000), nanosecondsPerCall(fixedPID, 1000));
+  printf("(the host has a floating point unit, so these do not reflect the Cortex, which emulates floating point in software; cycle counts there need the hardware)\n");
+
+  printf("%s\n", passed ? "PASS" : "FAIL");
+  return passed ? 0 : 1;
+}
+//#endregion
+
+//#region response curve
+static char powCurve(char input, double coeff, double powMap, unsigned char deadband) {  //JoystickGroup::takeInput()'s mapping before ResponseCurve (with NaN and overflow fixed)
+  double power = coeff * copysign(127 * pow(fabs(input / 127.0), powMap), input);
+  power = fmin(fmax(power, -127), 127);
+  return (fabs(power) < deadband ? 0 : power);
+}
+
+static volatile char charSink;
+
+static int responseCurve() {
+  const double coeffs[] = { 0.5, 1, 1.5 };
+  const double powMaps[] = { 1, 1.7, 2, 3 };
+  const unsigned char deadbands[] = { 0, 10 };
+  unsigned int mismatches = 0;
+
+  for (double coeff : coeffs) for (double powMap : powMaps) for (unsigned char deadband : deadbands) {
+    ResponseCurve curve(coeff, powMap, deadband);
+
+    for (int input=-128; input<=127; input++)
+      if (curve.map(input) != powCurve(input, coeff, powMap, deadband)) mismatches++;
+  }
+
+  bool passed = check("table entries differing from pow() mapping", mismatches, 0);
+
+  const unsigned int calls = 1000000;
+  ResponseCurve curve(1, 1.7, 10);
+  double start = wallNanoseconds();
+  for (unsigned int i=0; i<calls; i++) charSink = powCurve(i, 1, 1.7, 10);
+  double powTime = (wallNanoseconds() - start) / calls;
+
+  start = wallNanoseconds();
+  for (unsigned int i=0; i<calls; i++) charSink = curve.map(i);
+  double tableTime = (wallNanoseconds() - start) / calls;
+
+  printf("\nns per mapped input on this host: pow() %.2f, table %.2f (including loop overhead)\n", powTime, tableTime);
+
+  printf("%s\n", passed ? "PASS" : "FAIL");
+  return passed ? 0 : 1;
+}
+//#endregion
+
+//#region fast math
+/* Sweeps the approximations in coreIncludes.h and binaryAngle.h against
+  double-precision libm over the ranges their documented error bounds cover */
+static double sinCosError() {
+  double maxError = 0;
+
+  for (int i=-1000000; i<=1000000; i++) {
+    float x = i / 10000.0;
+    maxError = fmax(maxError, fabs(fastSin(x) - sin((double)x)));
+    maxError = fmax(maxError, fabs(fastCos(x) - cos((double)x)));
+  }
+
+  return maxError;
+}
+
+static double atan2Error() {
+  const double radii[] = { 0.001, 1, 1000 };
+  double maxError = 0;
+
+  for (double radius : radii) {
+    for (int i=-100000; i<=100000; i++) {
+      double angle = PI * i / 100000;
+      float y = radius*sin(angle) + 0.0f, x = radius*cos(angle) + 0.0f;  //+0 turns -0 into 0, on which atan2() and fastAtan2() disagree by 2pi
+      maxError = fmax(maxError, fabs(fastAtan2(y, x) - atan2((double)y, (double)x)));
+    }
+  }
+
+  return maxError;
+}
+
+static double sqrtRelativeError() {
+  double maxError = 0;
+
+  for (int i=0; i<=1000000; i++) {
+    float x = pow(10, -6 + 14.0*i/1000000);
+    maxError = fmax(maxError, fabs(fastSqrt(x) / sqrt((double)x) - 1));
+  }
+
+  return maxError;
+}
+
+static double bamSinError() {
+  double maxError = 0;
+
+  for (uint32_t i=0; i<(1u << 20); i++) {
+    bam angle = i << 12;
+    maxError = fmax(maxError, fabs(bamSin(angle) - sin(angle * (2*PI / 4294967296.0))));
+    maxError = fmax(maxError, fabs(bamCos(angle) - cos(angle * (2*PI / 4294967296.0))));
+  }
+
+  return maxError;
+}
+
+template <typename Function>
+static double nanosecondsPerCall(Function function) {
+  const unsigned int calls = 1000000;
+  double start = wallNanoseconds();
+
+  for (unsigned int i=0; i<calls; i++)
+    sink = function(i * 0.0001f);
+
+  return (wallNanoseconds() - start) / calls;
+}
+
+static int fastMath() {
+  bool passed = check("fastSin/fastCos max absolute error", sinCosError(), 7.4e-7);
+  passed = check("fastAtan2 max absolute error (radians)", atan2Error(), 1.2e-5) && passed;
+  passed = check("fastSqrt max relative error", sqrtRelativeError(), 4.8e-6) && passed;
+  passed = check("bamSin/bamCos max absolute error", bamSinError(), 1.9e-5) && passed;
+
+  printf("\nns per call on this host (fast / libm float / libm double):\n");
+  printf("  sin   %6.2f / %6.2f / %6.2f\n", nanosecondsPerCall([](float x) { return fastSin(x); }),
+         nanosecondsPerCall([](float x) { return sinf(x); }), nanosecondsPerCall([](float x) { return (float)sin((double)x); }));
+  printf("  atan2 %6.2f / %6.2f / %6.2f\n", nanosecondsPerCall([](float x) { return fastAtan2(x, 1 - x); }),
+         nanosecondsPerCall([](float x) { return atan2f(x, 1 - x); }), nanosecondsPerCall([](float x) { return (float)atan2((double)x, 1.0 - x); }));
+  printf("  sqrt  %6.2f / %6.2f / %6.2f\n", nanosecondsPerCall([](float x) { return fastSqrt(x); }),
+         nanosecondsPerCall([](float x) { return sqrtf(x); }), nanosecondsPerCall([](float x) { return (float)sqrt((double)x); }));
+  printf("  bamSin %5.2f\n", nanosecondsPerCall([](float x) { return bamSin(x * 1e6f); }));
+  printf("(the host has a floating point unit, so libm is much cheaper here than on the Cortex)\n");
+
+  printf("%s\n", passed ? "PASS" : "FAIL");
+  return passed ? 0 : 1;
+}
+//#endregion
+
+//#region PID step response
+/* Steps the simulated flapper with several PID configurations and checks
+  that output limits with anti-windup (and the derivative filter) keep
+  overshoot and settling time in check. PreviousPID is PID::evaluate() as it
+  was before output limits were added, including its precedence bug, and its
+  output is converted straight to char as MotorGroup used to. */
+class PreviousPID {
+  public:
+    PreviousPID(real_t target, real_t kP, real_t kI, real_t kD) : target(target), kP(kP), kI(kI), kD(kD), integralMax(0), integral(0), prevError(0), prevOutput(0) {}
+    void changeTarget(real_t target) {
+      this->target = target;
+      integral = 0;
+      prevError = 0;
+      updateTimer.reset();
+    }
+    real_t evaluate(real_t input) {
+      if (updateTimer.timeMicros() > 30000) {
+        updateTimer.reset();
+        real_t error = target - input;
+        integral += (kI!=0 && integralMax!=0 && fabs(error)>integralMax) ? error : copysign(integralMax, error); //how kI * (...) ? error : ... parsed
+        prevOutput = kP*error + integral + kD*(error - prevError);
+        prevError = error;
+      }
+
+      return prevOutput;
+    }
+  private:
+    real_t target, kP, kI, kD, integralMax, integral, prevError, prevOutput;
+    TickTimer updateTimer;
+};
+
+struct StepResult {
+  double overshoot;     //percent of step
+  double settlingTime;  //seconds until error stays within 2% of step (negative if it never does)
+  int finalError;
+};
+
+template <class Controller>
+static StepResult stepResponse(Controller &pid, int step, bool wrapOutput=false) {
+  const unsigned long duration = 8000; //milliseconds
+
+  flapper.setPower(-40);  //start each step from the bottom stop
+  delay(1500);
+  flapper.setPower(0);
+  delay(500);
+  SensorCache::refresh();
+
+  int target = flapper.getPosition() + step;
+  pid.changeTarget(target);
+  StepResult result = { 0, 0, 0 };
+  Timer stepTimer;
+
+  while (stepTimer.time() < duration) {
+    delay(10);
+    SensorCache::refresh();
+    int position = flapper.getPosition();
+    real_t output = pid.evaluate(position);
+    flapper.setPower(wrapOutput ? (char)(int)output : (char)fmin(fmax(output, -127), 127));
+
+    result.overshoot = fmax(result.overshoot, 100.0 * (position - target) / step);
+    if (abs(target - position) > step/50) result.settlingTime = stepTimer.time() / 1000.0;
+    result.finalError = target - position;
+  }
+
+  flapper.setPower(0);
+  if (result.settlingTime >= duration/1000.0 - 0.5) result.settlingTime = -1;  //still moving near the end
+  return result;
+}
+
+static void printStep(real_t kI, int step, const char *implementation, const StepResult &result) {
+  char settling[16];
+  if (result.settlingTime < 0) snprintf(settling, sizeof(settling), ">8 s");
+  else snprintf(settling, sizeof(settling), "%.2f s", result.settlingTime);
+
+  printf("  %-6g %5d %-28s %6.1f%% %9s %9d\n", kI, step, implementation, result.overshoot, settling, result.finalError);
+}
+
+static bool settles(const StepResult &result, double maxOvershoot, double maxTime) {
+  return result.settlingTime >= 0 && result.settlingTime <= maxTime && result.overshoot <= maxOvershoot && abs(result.finalError) <= 30;
+}
+
+static int pidStep() {
+  const real_t kP = 0.2, kD = 0.03;
+  bool passed = true;
+
+  flapper.deactivatePositionTargeting();  //keeps the background job from setting power
+  flapper.setPotReversed(false);          //in the simulation, positive power raises the potentiometer reading
+
+  printf("Flapper steps with kP=%g, kD=%g, settling to 2%%:\n", kP, kD);
+  printf("  kI      step implementation               overshoot  settling final err\n");
+
+  const real_t kIs[] = { 0.001, 0.01 };
+
+  for (real_t kI : kIs) {
+    PreviousPID previous(0, kP, kI, kD);
+    printStep(kI, 1500, "previous", stepResponse(previous, 1500, true));
+
+    PID conditional(0, kP, kI, kD);
+    conditional.setOutputLimits(-127, 127);
+    conditional.setAntiWindup(CONDITIONAL_INTEGRATION);
+    StepResult conditionalResult = stepResponse(conditional, 1500);
+    printStep(kI, 1500, "limits + conditional", conditionalResult);
+    passed = settles(conditionalResult, 10, 5) && passed;
+
+    if (kI < 0.005) continue;  //the remaining configurations only differ once the integral matters
+
+    PID noAntiWindup(0, kP, kI, kD);
+    noAntiWindup.setOutputLimits(-127, 127);
+    StepResult noAntiWindupResult = stepResponse(noAntiWindup, 1500);
+    printStep(kI, 1500, "limits, no anti-windup", noAntiWindupResult);
+    passed = (conditionalResult.overshoot < noAntiWindupResult.overshoot) && passed;  //anti-windup must help
+
+    PID backCalculation(0, kP, kI, kD);
+    backCalculation.setOutputLimits(-127, 127);
+    backCalculation.setAntiWindup(BACK_CALCULATION);
+    StepResult backCalculationResult = stepResponse(backCalculation, 1500);
+    printStep(kI, 1500, "limits + back-calculation", backCalculationResult);
+    passed = settles(backCalculationResult, 10, 5) && passed;
+
+    PID filtered(0, kP, kI, kD);
+    filtered.setOutputLimits(-127, 127);
+    filtered.setAntiWindup(CONDITIONAL_INTEGRATION);
+    filtered.setDerivativeOnMeasurement(true);
+    filtered.setDerivativeFilter(0.5);
+    StepResult filteredResult = stepResponse(filtered, 1500);
+    printStep(kI, 1500, "conditional + D filter", filteredResult);
+    passed = settles(filteredResult, 10, 5) && passed;
+
+    FixedPID fixedPID(0, kP, kI, kD);
+    fixedPID.setOutputLimits(-127, 127);
+    fixedPID.setAntiWindup(CONDITIONAL_INTEGRATION);
+    StepResult fixedResult = stepResponse(fixedPID, 1500);
+    printStep(kI, 1500, "FixedPID conditional", fixedResult);
+    passed = (fabs(fixedResult.overshoot - conditionalResult.overshoot) < 1 && fabs(fixedResult.settlingTime - conditionalResult.settlingTime) < 0.2) && passed;
+
+    PreviousPID previousSmall(0, kP, kI, kD);
+    printStep(kI, 300, "previous", stepResponse(previousSmall, 300, true));
+
+    PID conditionalSmall(0, kP, kI, kD);
+    conditionalSmall.setOutputLimits(-127, 127);
+    conditionalSmall.setAntiWindup(CONDITIONAL_INTEGRATION);
+    StepResult conditionalSmallResult = stepResponse(conditionalSmall, 300);
+    printStep(kI, 300, "limits + conditional", conditionalSmallResult);
+    passed = settles(conditionalSmallResult, 10, 5) && passed;
+  }
+
+  printf("%s\n", passed ? "PASS" : "FAIL");
+  return passed ? 0 : 1;
+}
+//#endregion
+
+//#region autotuning
+/* Autotunes the simulated flapper with each rule, first with its own
+  position PID and then in PIDBank, and checks that the test succeeds with
+  plausible results and that the tuned group then follows a step */
+static bool autotuneTrial(tuningRule rule, const char *controller) {
+  const int setpoint = 800, step = 1000;
+  Timer testTimer;
+  AutotuneResult result = flapper.autotunePosPID(setpoint, rule);
+  unsigned long testTime = testTimer.time();
+
+  //step response of the tuned group, which holds the target in the background
+  int target = setpoint + step;
+  double overshoot = 0;
+  unsigned long settlingTime = 0;
+  int position = 0;
+  flapper.setTargetPosition(target);
+  Timer stepTimer;
+
+  while (stepTimer.time() < 3000) {
+    delay(10);
+    position = flapper.getPosition();
+    overshoot = fmax(overshoot, 100.0 * (position - target) / step);
+    if (abs(target - position) > step/50) settlingTime = stepTimer.time();
+  }
+
+  printf("  %-3s %-8s %-7s %6.2f %6.0f ms %6.3f %8.5f %7.3f %7lu ms %6.1f%% %6lu ms %6d\n",
+         rule==ZIEGLER_NICHOLS ? "ZN" : "TL", controller, result.success ? "yes" : "no", result.ultimateGain, result.ultimatePeriod,
+         result.kP, result.kI, result.kD, testTime, overshoot, settlingTime, target - position);
+
+  return result.success && result.ultimateGain > 0.5 && result.ultimateGain < 50 && result.ultimatePeriod > 20 && result.ultimatePeriod < 2000
+         && overshoot < 10 && settlingTime < 2000 && abs(target - position) <= step/50;
+}
+
+static int autotune() {
+  bool passed = true;
+
+  flapper.setPotReversed(false);  //in the simulation, positive power raises the potentiometer reading
+
+  printf("Flapper relay autotune at 800 counts, then a 1000 count step (2%% settling):\n");
+  printf("  rule ctrl  success     Ku     Tu     kP       kI      kD      test  overshoot settling final err\n");
+
+  passed = autotuneTrial(ZIEGLER_NICHOLS, "PID") && passed;
+  passed = autotuneTrial(TYREUS_LUYBEN, "PID") && passed;
+
+  flapper.posPIDinitInBank(0, 0, 0);  //gains are set by the autotuner
+  passed = autotuneTrial(ZIEGLER_NICHOLS, "PIDBank") && passed;
+  passed = autotuneTrial(TYREUS_LUYBEN, "PIDBank") && passed;
+
+  printf("%s\n", passed ? "PASS" : "FAIL");
+  return passed ? 0 : 1;
+}
+//#endregion
+
+static const SimScenario scenarios[] = {
+  { "maneuvers", maneuvers, "runs 1000 alternating drive() and turn() calls and checks that heap use stays flat" },
+  { "fixedcontrol", fixedControl, "checks fixed-point PID and ramps against the floating point versions and times both" },
+  { "responsecurve", responseCurve, "checks ResponseCurve tables against the pow() mapping they replace and times both" },
+  { "fastmath", fastMath, "checks the fast math approximations' documented error bounds against libm and times them" },
+  { "pidstep", pidStep, "steps the flapper with several PID configurations and checks overshoot and settling time" },
+  { "autotune", autotune, "autotunes the flapper with both tuning rules and checks the results and the tuned step response" },
+};
+
+const SimScenario* simFindScenario(const char *name) {
+  for (unsigned int i=0; i<sizeof(scenarios)/sizeof(scenarios[0]); i++)
+    if (strcmp(scenarios[i].name, name) == 0) return &scenarios[i];
+
+  return NULL;
+}
+
+void simListScenarios() {
+  for (unsigned int i=0; i<sizeof(scenarios)/sizeof(scenarios[0]); i++)
+    printf("  %-14s %s\n", scenarios[i].name, scenarios[i].description);
+}
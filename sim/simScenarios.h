@@ -0,0 +1,24 @@
+/* Self-checking scenarios run by the simulator in place of autonomous() or
+  operatorControl() (`simulator <scenario>`)
+
+  Each scenario runs in the kernel task after initialize(), prints what it
+  measured and returns the simulator's exit status: 0 if every check passed,
+  1 otherwise. Scenarios which time code use the host's clock rather than
+  virtual time, so their timings are only comparable between runs on the
+  same machine. */
+
+#ifndef SIM_SCENARIOS_INCLUDED
+#define SIM_SCENARIOS_INCLUDED
+
+typedef int (*SimScenarioCode)();
+
+struct SimScenario {
+  const char *name;
+  SimScenarioCode run;
+  const char *description;
+};
+
+const SimScenario* simFindScenario(const char *name); //returns NULL if there is no scenario called name
+void simListScenarios();                              //prints name and description of every scenario
+
+#endif
@@ -0,0 +1,538 @@
+#include "simulation.h"
+#include <API.h>  //for TASK_* constants
+#include <cmath>
+#include <ucontext.h>
+
+#define SIM_TASK_STACK_SIZE (256 * 1024)  //bytes (host stacks are much hungrier than the Cortex's)
+
+static const double METERS_PER_INCH = 0.0254;
+static const double GRAVITY = 9.81;
+static const double TWO_PI = 2 * acos(-1);
+
+//#region state
+struct SimTask {
+  ucontext_t context;
+  void *stack;
+  SimTaskCode code;
+  void *parameters;
+  unsigned int priority, state;
+  uint64_t wakeTime;
+  bool used;
+};
+
+struct DriveSide {
+  double wheelSpeed;  //surface speed of wheel (m/s)
+  double groundSpeed; //speed of this side of the chassis over the ground (m/s)
+  double wheelAngle;  //radians
+  bool slipping;
+};
+
+static SimConfig config;
+//clock
+static uint64_t now, physicsTime, sliceStart;
+static unsigned long apiCalls;
+//scheduler
+static SimTask tasks[TASK_MAX];
+static SimTask *current;
+static ucontext_t schedulerContext;
+static unsigned char lastScheduled;
+static bool stopping;
+//hardware
+static int motorPowers[11];
+static int analogOverrides[BOARD_NR_ADC_PINS + 1];
+static bool analogOverridden[BOARD_NR_ADC_PINS + 1];
+static bool digitalPins[BOARD_NR_GPIO_PINS + 1];
+static int joystickAxes[2][7];
+static unsigned char joystickButtons[2][4];
+static uint32_t noiseState;
+//physics
+static DriveSide leftSide, rightSide;
+static double xPos, yPos, heading; //meters, meters, radians
+static double armAngle, armSpeed;  //radians, rad/s
+//#endregion
+
+//#region configuration
+void simDefaultConfig(SimConfig &c) {
+  c.motorStallTorque = 1.67;
+  c.motorFreeSpeed = 100;
+  c.motorBraking = false;
+
+  c.drive.leftMotors[0] = 1;
+  c.drive.rightMotors[0] = 2;
+  c.drive.numLeftMotors = 1;
+  c.drive.numRightMotors = 1;
+  c.drive.leftEncPort = 2;
+  c.drive.rightEncPort = 4;
+  c.drive.gyroPort = 5;
+  c.drive.wheelDiameter = 4.0;
+  c.drive.trackWidth = 15.0;
+  c.drive.gearRatio = 1;
+  c.drive.mass = 6.0;
+  c.drive.wheelInertia = 0.003;
+  c.drive.frictionCoeff = 0.7;
+  c.drive.rollingDrag = 2.0;
+  c.drive.encTicksPerRev = 360;
+  c.drive.gyroDrift = 0.05;
+  c.drive.gyroNoise = 0.5;
+  c.drive.gyroReversed = false;
+
+  c.arm.motors[0] = 3;
+  c.arm.numMotors = 1;
+  c.arm.potPort = 1;
+  c.arm.encPort = 0;
+  c.arm.gearRatio = 5;
+  c.arm.inertia = 0.05;
+  c.arm.friction = 0.5;
+  c.arm.gravityTorque = 2.0;
+  c.arm.minAngle = -30;
+  c.arm.maxAngle = 120;
+  c.arm.startAngle = -30;
+  c.arm.potRange = 250;
+
+  c.physicsStep = 1000;
+  c.apiCallCost = 2;
+  c.timeSlice = 1000;
+  c.duration = 15000;
+  c.autonomous = true;
+  c.enabled = true;
+}
+
+void simConfigure(const SimConfig &c) {
+  for (unsigned char i=0; i<TASK_MAX; i++) {
+    if (tasks[i].used) free(tasks[i].stack);
+    tasks[i].used = false;
+  }
+
+  config = c;
+  now = physicsTime = sliceStart = 0;
+  apiCalls = 0;
+  current = NULL;
+  lastScheduled = 0;
+  stopping = false;
+
+  for (unsigned char i=0; i<=10; i++) motorPowers[i] = 0;
+  for (unsigned char i=0; i<=BOARD_NR_ADC_PINS; i++) analogOverridden[i] = false;
+  for (unsigned char i=0; i<=BOARD_NR_GPIO_PINS; i++) digitalPins[i] = true;  //inputs are pulled up
+  for (unsigned char j=0; j<2; j++) {
+    for (unsigned char i=0; i<7; i++) joystickAxes[j][i] = 0;
+    for (unsigned char i=0; i<4; i++) joystickButtons[j][i] = 0;
+  }
+  noiseState = 12345;
+
+  leftSide = rightSide = DriveSide();
+  xPos = yPos = heading = 0;
+  armAngle = config.arm.startAngle * TWO_PI / 360;
+  armSpeed = 0;
+}
+
+const SimConfig& simGetConfig() { return config; }
+//#endregion
+
+//#region physics
+static double motorTorque(const unsigned char motors[], unsigned char numMotors, double motorSpeed) {
+  //linear torque curve of a DC motor: full stall torque at zero speed, zero torque at free speed
+  double freeSpeed = config.motorFreeSpeed * TWO_PI / 60;
+  double torque = 0;
+
+  for (unsigned char i=0; i<numMotors; i++) {
+    if (motorPowers[motors[i]] != 0 || config.motorBraking)
+      torque += config.motorStallTorque * (motorPowers[motors[i]]/127.0 - motorSpeed/freeSpeed);
+  }
+
+  return torque;
+}
+
+static void stepSide(DriveSide &side, const unsigned char motors[], unsigned char numMotors, double dt) {
+  const SimDriveConfig &d = config.drive;
+  double radius = d.wheelDiameter * METERS_PER_INCH / 2;
+  double sideMass = d.mass / 2;
+  double wheelMass = d.wheelInertia / (radius*radius);  //wheel inertia expressed as an equivalent mass at its surface
+  double maxTraction = d.frictionCoeff * sideMass * GRAVITY;
+
+  double wheelForce = motorTorque(motors, numMotors, side.wheelSpeed/radius * d.gearRatio) * d.gearRatio / radius;
+  double drag = d.rollingDrag * side.groundSpeed;
+
+  if (!side.slipping) {
+    //assume the wheel rolls, then check that the required traction is available
+    double acceleration = (wheelForce - drag) / (wheelMass + sideMass);
+    double traction = sideMass*acceleration + drag;
+
+    if (fabs(traction) <= maxTraction) {
+      side.groundSpeed += acceleration * dt;
+      side.wheelSpeed = side.groundSpeed;
+    } else {
+      side.slipping = true;
+    }
+  }
+
+  if (side.slipping) {
+    double prevSlip = side.wheelSpeed - side.groundSpeed;
+    double traction = copysign(maxTraction, prevSlip!=0 ? prevSlip : wheelForce);
+
+    side.wheelSpeed += (wheelForce - traction) / wheelMass * dt;
+    side.groundSpeed += (traction - drag) / sideMass * dt;
+
+    double slip = side.wheelSpeed - side.groundSpeed;
+
+    if (slip == 0 || (prevSlip != 0 && (slip > 0) != (prevSlip > 0))) { //wheel has regained grip
+      double speed = (wheelMass*side.wheelSpeed + sideMass*side.groundSpeed) / (wheelMass + sideMass);
+      side.wheelSpeed = side.groundSpeed = speed;
+      side.slipping = false;
+    }
+  }
+
+  side.wheelAngle += side.wheelSpeed / radius * dt;
+}
+
+static void stepArm(double dt) {
+  const SimArmConfig &a = config.arm;
+  double torque = motorTorque(a.motors, a.numMotors, armSpeed * a.gearRatio) * a.gearRatio
+                  - a.friction*armSpeed - a.gravityTorque*cos(armAngle);
+
+  armSpeed += torque / a.inertia * dt;
+  armAngle += armSpeed * dt;
+
+  double minAngle = a.minAngle * TWO_PI / 360;
+  double maxAngle = a.maxAngle * TWO_PI / 360;
+
+  if (armAngle < minAngle || armAngle > maxAngle) { //hit hard stop
+    armAngle = (armAngle < minAngle ? minAngle : maxAngle);
+    armSpeed = 0;
+  }
+}
+
+static void stepPhysics(double dt) {
+  stepSide(leftSide, config.drive.leftMotors, config.drive.numLeftMotors, dt);
+  stepSide(rightSide, config.drive.rightMotors, config.drive.numRightMotors, dt);
+
+  double speed = (leftSide.groundSpeed + rightSide.groundSpeed) / 2;
+  double angularSpeed = (rightSide.groundSpeed - leftSide.groundSpeed) / (config.drive.trackWidth * METERS_PER_INCH);
+
+  xPos += speed * cos(heading + angularSpeed*dt/2) * dt;
+  yPos += speed * sin(heading + angularSpeed*dt/2) * dt;
+  heading += angularSpeed * dt;
+
+  if (config.arm.numMotors > 0) stepArm(dt);
+}
+
+static void catchUpPhysics() {
+  if (config.physicsStep == 0) return;  //not configured yet (e.g. during static initialization)
+
+  while (physicsTime + config.physicsStep <= now) {
+    physicsTime += config.physicsStep;
+    stepPhysics(config.physicsStep / 1e6);
+  }
+}
+//#endregion
+
+//#region scheduler
+static void switchToScheduler() {
+  SimTask *task = current;
+  swapcontext(&task->context, &schedulerContext);
+}
+
+static void taskEntry() {
+  current->code(current->parameters);
+  current->state = TASK_DEAD;
+}
+
+static SimTask* findTask(void *handle) {
+  return handle ? static_cast<SimTask*>(handle) : current;
+}
+
+static SimTask* nextReadyTask() {
+  SimTask *next = NULL;
+
+  for (unsigned char offset=1; offset<=TASK_MAX; offset++) { //round robin, starting after last scheduled task
+    unsigned char i = (lastScheduled + offset) % TASK_MAX;
+    SimTask &task = tasks[i];
+
+    if (task.used && (task.state==TASK_RUNNABLE || (task.state==TASK_SLEEPING && task.wakeTime<=now))) {
+      if (!next || task.priority > next->priority)
+        next = &task;
+    }
+  }
+
+  if (next) lastScheduled = next - tasks;
+  return next;
+}
+
+static bool earliestWake(uint64_t &wake) {
+  bool found = false;
+
+  for (unsigned char i=0; i<TASK_MAX; i++) {
+    if (tasks[i].used && tasks[i].state==TASK_SLEEPING && (!found || tasks[i].wakeTime < wake)) {
+      wake = tasks[i].wakeTime;
+      found = true;
+    }
+  }
+
+  return found;
+}
+
+static void releaseTask(SimTask &task) {
+  free(task.stack);
+  task.used = false;
+}
+
+void* simTaskCreate(SimTaskCode code, void *parameters, unsigned int priority) {
+  for (unsigned char i=0; i<TASK_MAX; i++) {
+    SimTask &task = tasks[i];
+
+    if (!task.used) {
+      task.stack = malloc(SIM_TASK_STACK_SIZE);
+      if (!task.stack) return NULL;
+
+      getcontext(&task.context);
+      task.context.uc_stack.ss_sp = task.stack;
+      task.context.uc_stack.ss_size = SIM_TASK_STACK_SIZE;
+      task.context.uc_link = &schedulerContext;
+      makecontext(&task.context, taskEntry, 0);
+
+      task.code = code;
+      task.parameters = parameters;
+      task.priority = priority<TASK_MAX_PRIORITIES ? priority : TASK_PRIORITY_HIGHEST;
+      task.state = TASK_RUNNABLE;
+      task.used = true;
+      return &task;
+    }
+  }
+
+  return NULL;  //too many tasks
+}
+
+void simTaskDelete(void *handle) {
+  SimTask *task = findTask(handle);
+  if (!task) return;
+
+  if (task == current) {
+    task->state = TASK_DEAD;
+    switchToScheduler();  //never returns
+  } else if (task->used) {
+    releaseTask(*task);
+  }
+}
+
+void* simCurrentTask() { return current; }
+
+unsigned int simTaskState(void *handle) {
+  SimTask *task = findTask(handle);
+  return (task && task->used) ? task->state : TASK_DEAD;
+}
+
+unsigned int simTaskPriority(void *handle) {
+  SimTask *task = findTask(handle);
+  return task ? task->priority : TASK_PRIORITY_DEFAULT;
+}
+
+void simSetTaskPriority(void *handle, unsigned int priority) {
+  SimTask *task = findTask(handle);
+  if (task) task->priority = priority<TASK_MAX_PRIORITIES ? priority : TASK_PRIORITY_HIGHEST;
+}
+
+void simSuspendTask(void *handle, bool suspended) {
+  SimTask *task = findTask(handle);
+  if (!task || !task->used) return;
+
+  if (suspended) {
+    task->state = TASK_SUSPENDED;
+    if (task == current) switchToScheduler();
+  } else if (task->state == TASK_SUSPENDED) {
+    task->state = TASK_RUNNABLE;
+  }
+}
+
+unsigned int simTaskCount() {
+  unsigned int count = 0;
+
+  for (unsigned char i=0; i<TASK_MAX; i++)
+    if (tasks[i].used) count++;
+
+  return count;
+}
+
+void simRun() {
+  if (current) return;  //cannot be called from inside a task
+
+  while (!stopping) {
+    SimTask *next = nextReadyTask();
+
+    if (next) {
+      current = next;
+      current->state = TASK_RUNNING;
+      sliceStart = now;
+      swapcontext(&schedulerContext, &current->context);
+
+      if (current->state == TASK_DEAD) releaseTask(*current);
+      current = NULL;
+    } else {  //idle until next task wakes
+      uint64_t wake = 0;
+      if (!earliestWake(wake)) break;  //all tasks are finished or suspended
+
+      simSleepUntil(wake);
+    }
+  }
+}
+
+void simStop() {
+  stopping = true;
+  if (current) switchToScheduler();
+}
+//#endregion
+
+//#region time
+uint64_t simTime() { return now; }
+
+void simAdvance(unsigned long us) {
+  now += us;
+  apiCalls++;
+
+  if (config.duration != 0 && now >= (uint64_t)config.duration * 1000) {
+    now = (uint64_t)config.duration * 1000;
+    catchUpPhysics();
+    simStop();
+  }
+
+  catchUpPhysics();
+
+  if (current && now - sliceStart >= config.timeSlice) simYield();
+}
+
+void simSleepUntil(uint64_t time) {
+  if (current) {
+    current->state = TASK_SLEEPING;
+    current->wakeTime = time;
+    switchToScheduler();
+  } else {  //idle
+    if (config.duration != 0 && time >= (uint64_t)config.duration * 1000) {
+      time = (uint64_t)config.duration * 1000;
+      stopping = true;
+    }
+
+    if (time > now) now = time;
+    catchUpPhysics();
+  }
+}
+
+void simYield() {
+  if (current) {
+    current->state = TASK_RUNNABLE;
+    switchToScheduler();
+  }
+}
+//#endregion
+
+//#region hardware state
+void simSetMotor(unsigned char channel, int power) {
+  if (1<=channel && channel<=10)
+    motorPowers[channel] = power>127 ? 127 : (power<-127 ? -127 : power);
+}
+
+int simGetMotor(unsigned char channel) {
+  return (1<=channel && channel<=10) ? motorPowers[channel] : 0;
+}
+
+int simEncoderTicks(unsigned char topPort) {
+  double angle;
+
+  if (topPort == 0)
+    return 0;
+  else if (topPort == config.drive.leftEncPort)
+    angle = leftSide.wheelAngle;
+  else if (topPort == config.drive.rightEncPort)
+    angle = rightSide.wheelAngle;
+  else if (topPort == config.arm.encPort)
+    angle = armAngle - config.arm.startAngle*TWO_PI/360;
+  else
+    return 0;
+
+  double ticksPerRev = (topPort==config.arm.encPort ? 360 : config.drive.encTicksPerRev);
+  return angle / TWO_PI * ticksPerRev;
+}
+
+int simGyroDegrees() {
+  noiseState = noiseState*1103515245 + 12345;
+  double noise = config.drive.gyroNoise * (((noiseState >> 16) & 0x7FFF) / 16383.5 - 1);
+  double angle = heading*360/TWO_PI * (config.drive.gyroReversed ? -1 : 1);
+
+  return angle + config.drive.gyroDrift*now/1e6 + noise;
+}
+
+int simPotValue(unsigned char port) {
+  if (port == 0 || port > BOARD_NR_ADC_PINS) return 0;
+  if (analogOverridden[port]) return analogOverrides[port];
+
+  if (port == config.arm.potPort) {
+    int value = (armAngle*360/TWO_PI - config.arm.minAngle) / config.arm.potRange * 4095;
+    return value<0 ? 0 : (value>4095 ? 4095 : value);
+  }
+
+  return 0;
+}
+
+void simSetAnalog(unsigned char port, int value) {
+  if (1<=port && port<=BOARD_NR_ADC_PINS) {
+    analogOverrides[port] = value;
+    analogOverridden[port] = true;
+  }
+}
+
+bool simGetDigital(unsigned char pin) {
+  return (1<=pin && pin<=BOARD_NR_GPIO_PINS) ? digitalPins[pin] : false;
+}
+
+void simSetDigital(unsigned char pin, bool value) {
+  if (1<=pin && pin<=BOARD_NR_GPIO_PINS) digitalPins[pin] = value;
+}
+
+void simSetJoystickAnalog(unsigned char joystick, unsigned char axis, int value) {
+  if (1<=joystick && joystick<=2 && 1<=axis && axis<=6)
+    joystickAxes[joystick-1][axis] = value;
+}
+
+void simSetJoystickDigital(unsigned char joystick, unsigned char buttonGroup, unsigned char button, bool pressed) {
+  if (1<=joystick && joystick<=2 && 5<=buttonGroup && buttonGroup<=8) {
+    if (pressed)
+      joystickButtons[joystick-1][buttonGroup-5] |= button;
+    else
+      joystickButtons[joystick-1][buttonGroup-5] &= ~button;
+  }
+}
+
+int simGetJoystickAnalog(unsigned char joystick, unsigned char axis) {
+  if (1<=joystick && joystick<=2 && 1<=axis && axis<=6)
+    return joystickAxes[joystick-1][axis];
+
+  return 0;
+}
+
+bool simGetJoystickDigital(unsigned char joystick, unsigned char buttonGroup, unsigned char button) {
+  if (1<=joystick && joystick<=2 && 5<=buttonGroup && buttonGroup<=8)
+    return joystickButtons[joystick-1][buttonGroup-5] & button;
+
+  return false;
+}
+//#endregion
+
+//#region ground truth
+SimPose simGetPose() {
+  SimPose pose;
+  pose.x = xPos / METERS_PER_INCH;
+  pose.y = yPos / METERS_PER_INCH;
+  pose.theta = heading;
+  pose.leftSpeed = leftSide.groundSpeed / METERS_PER_INCH;
+  pose.rightSpeed = rightSide.groundSpeed / METERS_PER_INCH;
+  pose.leftSlip = (leftSide.wheelSpeed - leftSide.groundSpeed) / METERS_PER_INCH;
+  pose.rightSlip = (rightSide.wheelSpeed - rightSide.groundSpeed) / METERS_PER_INCH;
+  return pose;
+}
+
+void simSetPose(double x, double y, double theta) {
+  xPos = x * METERS_PER_INCH;
+  yPos = y * METERS_PER_INCH;
+  heading = theta;
+}
+
+double simArmAngle() { return armAngle * 360 / TWO_PI; }
+unsigned long simApiCalls() { return apiCalls; }
+//#endregion
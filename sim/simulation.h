@@ -0,0 +1,150 @@
+/* Host-side simulation of the PROS API (API.h) for building and running the
+  library on a desktop machine
+
+  Provides a virtual clock, a cooperative model of the PROS task scheduler and
+  a physics model of a differential drive (plus a single-jointed arm for
+  potentiometer-based MotorGroups). simAPI.cpp implements the API.h surface on
+  top of this, so the unchanged files in src/ can be linked against it with
+  `make sim`.
+
+  Time only advances through the simulation: every API call costs
+  SimConfig::apiCallCost microseconds of virtual time, and delay()/taskDelay()
+  skip ahead directly. Busy-wait loops therefore still make progress, and a
+  run is fully deterministic for a given config.
+
+  This header deliberately does not include API.h (whose FILE typedef clashes
+  with the host's stdio), so host-side tools can include it freely. */
+
+#ifndef SIMULATION_INCLUDED
+#define SIMULATION_INCLUDED
+
+#include <stdint.h>
+
+#define SIM_MAX_GROUP_MOTORS 10
+
+//#region configuration
+struct SimDriveConfig {
+  unsigned char leftMotors[SIM_MAX_GROUP_MOTORS], rightMotors[SIM_MAX_GROUP_MOTORS];  //motor ports on each side
+  unsigned char numLeftMotors, numRightMotors;
+  unsigned char leftEncPort, rightEncPort;  //top port of the encoder attached to each side (0 if none)
+  unsigned char gyroPort;                   //analog port of gyro (0 if none)
+  double wheelDiameter;     //inches
+  double trackWidth;        //inches (wheel well to wheel well)
+  double gearRatio;         //motor revolutions per wheel revolution
+  double mass;              //kg
+  double wheelInertia;      //kg*m^2 of each side's wheels and drivetrain, referred to the wheel axle
+  double frictionCoeff;     //coefficient of friction between wheels and field (limits traction before wheels slip)
+  double rollingDrag;       //N per m/s of ground speed, per side
+  double encTicksPerRev;    //encoder ticks per wheel revolution
+  double gyroDrift;         //degrees per second of constant gyro drift
+  double gyroNoise;         //maximum absolute gyro noise (degrees)
+  bool gyroReversed;        //if false, counterclockwise rotation is positive (matches ParallelDrive's odometry)
+};
+
+struct SimArmConfig {
+  unsigned char motors[SIM_MAX_GROUP_MOTORS];
+  unsigned char numMotors;
+  unsigned char potPort;  //analog port of potentiometer (0 if none)
+  unsigned char encPort;  //top port of encoder on arm's axle (0 if none)
+  double gearRatio;       //motor revolutions per arm revolution
+  double inertia;         //kg*m^2 about arm pivot
+  double friction;        //viscous friction (N*m per rad/s)
+  double gravityTorque;   //N*m of gravity torque when arm is horizontal
+  double minAngle, maxAngle, startAngle;  //hard stops and initial position (degrees from horizontal)
+  double potRange;        //degrees of rotation corresponding to the full 0-4095 potentiometer range
+};
+
+struct SimConfig {
+  //motor model (linear DC motor torque curve, defaults are for a VEX 393)
+  double motorStallTorque;  //N*m at full power
+  double motorFreeSpeed;    //rpm at full power
+  bool motorBraking;        //whether motors set to 0 power brake (otherwise they coast, like VEX motor controllers)
+  //mechanisms
+  SimDriveConfig drive;
+  SimArmConfig arm;
+  //timing
+  unsigned long physicsStep;  //microseconds between physics updates
+  unsigned long apiCallCost;  //microseconds of virtual time consumed by each API call
+  unsigned long timeSlice;    //microseconds a task may run before equal priority tasks are scheduled
+  unsigned long duration;     //milliseconds after which the simulation ends (0 to run until all tasks finish)
+  //competition state
+  bool autonomous, enabled;
+};
+
+void simDefaultConfig(SimConfig &config);
+/* Fills config with the defaults, which match the port layout in config.h */
+
+void simConfigure(const SimConfig &config);
+/* Resets the simulation to its initial state using config */
+
+const SimConfig& simGetConfig();
+//#endregion
+
+//#region running
+typedef void (*SimTaskCode)(void *);
+
+void* simTaskCreate(SimTaskCode code, void *parameters, unsigned int priority);
+/* Schedules a new task. Returns a handle usable with the functions below. */
+
+void simTaskDelete(void *task); //deletes the specified task (or the current task if NULL)
+void* simCurrentTask();         //returns NULL when called outside of a task
+unsigned int simTaskState(void *task);  //uses the TASK_* state values of API.h
+unsigned int simTaskPriority(void *task);
+void simSetTaskPriority(void *task, unsigned int priority);
+void simSuspendTask(void *task, bool suspended);
+unsigned int simTaskCount();
+
+void simRun();
+/* Runs scheduled tasks until the configured duration elapses or every task
+  finishes. Must be called from outside of a task. */
+
+void simStop(); //ends simRun() after the current API call
+//#endregion
+
+//#region time
+uint64_t simTime();                 //current virtual time in microseconds
+void simAdvance(unsigned long us);  //consumes virtual time on behalf of the current task
+void simSleepUntil(uint64_t time);  //suspends the current task until the specified time
+void simYield();                    //lets other ready tasks of equal or higher priority run
+//#endregion
+
+//#region hardware state
+void simSetMotor(unsigned char channel, int power);
+int simGetMotor(unsigned char channel);
+
+int simEncoderTicks(unsigned char topPort); //accumulated ticks of the encoder with specified top port
+int simGyroDegrees();                       //current (noisy, drifting) gyro reading before any resets
+int simPotValue(unsigned char port);        //potentiometer reading (or value set by simSetAnalog())
+void simSetAnalog(unsigned char port, int value); //overrides reading of an unmodeled analog port
+bool simGetDigital(unsigned char pin);
+void simSetDigital(unsigned char pin, bool value);
+
+void simSetJoystickAnalog(unsigned char joystick, unsigned char axis, int value);
+void simSetJoystickDigital(unsigned char joystick, unsigned char buttonGroup, unsigned char button, bool pressed);
+int simGetJoystickAnalog(unsigned char joystick, unsigned char axis);
+bool simGetJoystickDigital(unsigned char joystick, unsigned char buttonGroup, unsigned char button);
+//#endregion
+
+//#region ground truth
+struct SimPose {
+  double x, y, theta;             //inches, inches, radians (counterclockwise from +x)
+  double leftSpeed, rightSpeed;   //ground speed of each side (inches/second)
+  double leftSlip, rightSlip;     //wheel surface speed minus ground speed (inches/second)
+};
+
+SimPose simGetPose();
+void simSetPose(double x, double y, double theta);
+double simArmAngle();   //degrees from horizontal
+unsigned long simApiCalls();  //number of API calls made since simConfigure()
+//#endregion
+
+//#region heap usage
+struct SimHeapStats {
+  unsigned long bytesInUse, highWater;  //bytes allocated with new (and not yet deleted)
+  unsigned long allocations;            //total calls to new
+};
+
+SimHeapStats simHeapStats();  //counts allocations made through new since the program started
+//#endregion
+
+#endif
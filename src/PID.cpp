@@ -1,21 +1,46 @@
 #include "PID.h"
-#include "timer.h"
 #include <cmath>
 
-double PID::evaluate(double input) {
-	unsigned long elapsed = updateTimer->time();
+real_t PID::evaluate(real_t input) {
+	unsigned long elapsed = updateTimer.timeMicros();
 
-	if (elapsed > minSampleTime) {
-		updateTimer->reset();
-		double error = target - input;
-		unsigned short timeCorrectionFactor = useTimeAdjustment ? elapsed : 1;
+	if (elapsed > minSampleTime*1000ul) {
+		updateTimer.reset();
+		real_t error = target - input;
+		real_t interval = useTimeAdjustment ? elapsed/1000.0 : 1;	//milliseconds
 
-		integral += kI * (integralMax!=0 && fabs(error)>integralMax) ? error : copysign(integralMax, error);	//TODO: should this compare error or output to integralMax?
+		real_t limitedError = (integralMax==0 || fabs(error)<=integralMax) ? error : copysign(integralMax, error);
+		real_t newIntegral = integral + kI*limitedError*interval;
 		/* Adds error if |error| < integralMax, otherwise add integralMax*sgn(error)
 				kI is factored in here to avoid problems when changing gain coeffs. */
 
-		prevOutput = kP*error + integral*timeCorrectionFactor + kD*(error - prevError)/timeCorrectionFactor;
+		real_t derivative = 0;
+
+		if (!firstSample) {
+			real_t change = derivativeOnMeasurement ? prevInput-input : error-prevError;	//the same unless target has changed
+			derivative = kD*change / interval;
+			if (derivativeWeight < 1) derivative = prevDerivative + derivativeWeight*(derivative - prevDerivative);
+		}
+
+		real_t output = kP*error + newIntegral + derivative;
+
+		if (outputMin < outputMax && (output < outputMin || output > outputMax)) {	//saturated
+			real_t limited = fmin(fmax(output, outputMin), outputMax);
+
+			if (antiWindup == CONDITIONAL_INTEGRATION && limitedError*(output-limited) > 0)	//integrating would push output further past limit
+				newIntegral = integral;
+			else if (antiWindup == BACK_CALCULATION)
+				newIntegral += trackingGain * (limited - output);
+
+			output = limited;
+		}
+
+		integral = newIntegral;
+		prevOutput = output;
 		prevError = error;
+		prevInput = input;
+		prevDerivative = derivative;
+		firstSample = false;
 	}
 
 	return prevOutput;
@@ -24,35 +49,53 @@ double PID::evaluate(double input) {
 void PID::reset() {
 	integral = 0;
 	prevError = 0;
-	updateTimer->reset();
+	prevDerivative = 0;
+	firstSample = true;
+	updateTimer.reset();
 }
 
-void PID::changeTarget(double target) {
+void PID::changeTarget(real_t target) {
 	this->target = target;
 	reset();	//TODO: add options?
 }
 
-PID::PID(double target, double kP, double kI, double kD, unsigned short minSampleTime, double integralMax, bool useTimeAdjustment)
-					: target(target), kP(kP), kI(kI), kD(kD), minSampleTime(minSampleTime), integralMax(fabs(integralMax)), useTimeAdjustment(useTimeAdjustment) {
+PID::PID(real_t target, real_t kP, real_t kI, real_t kD, unsigned short minSampleTime, real_t integralMax, bool useTimeAdjustment)
+					: target(target), kP(kP), kI(kI), kD(kD), minSampleTime(minSampleTime), integralMax(fabs(integralMax)), useTimeAdjustment(useTimeAdjustment),
+					  outputMin(0), outputMax(0), antiWindup(NO_ANTI_WINDUP), trackingGain(0), derivativeOnMeasurement(false), derivativeWeight(1) {
 	integral = 0;
 	prevError = 0;
-	updateTimer = new Timer();
+	prevInput = 0;
+	prevDerivative = 0;
+	prevOutput = 0;
+	firstSample = true;
 }
 
 //#region accessors and mutators
-double PID::get_kP() { return kP; }
-double PID::get_kI() { return kI; }
-double PID::get_kD() { return kD; }
-void PID::setCoeffs(double kP, double kI, double kD) {
+real_t PID::get_kP() { return kP; }
+real_t PID::get_kI() { return kI; }
+real_t PID::get_kD() { return kD; }
+void PID::setCoeffs(real_t kP, real_t kI, real_t kD) {
 	this->kP = kP;
 	this->kI = kI;
 	this->kD = kD;
 }
-double PID::getTarget() { return target; }
-double PID::getIntegral() { return integral; }
-void PID::setIntegral(double integral) { this->integral = integral; }
+real_t PID::getTarget() { return target; }
+real_t PID::getIntegral() { return integral; }
+void PID::setIntegral(real_t integral) { this->integral = integral; }
 unsigned short PID::getMinSampleTime() { return minSampleTime; }
 void PID::setMinSampleTime(unsigned short minSampleTime) { this->minSampleTime = minSampleTime; }
-double PID::getIntegralMax() { return integralMax; }
-void PID::setIntegralMax(double max) { integralMax = max; }
+real_t PID::getIntegralMax() { return integralMax; }
+void PID::setIntegralMax(real_t max) { integralMax = max; }
+	//#subregion robustness options
+void PID::setOutputLimits(real_t min, real_t max) {
+	outputMin = min;
+	outputMax = max;
+}
+void PID::setAntiWindup(antiWindupType type, real_t trackingGain) {
+	antiWindup = type;
+	this->trackingGain = trackingGain;
+}
+void PID::setDerivativeOnMeasurement(bool onMeasurement) { derivativeOnMeasurement = onMeasurement; }
+void PID::setDerivativeFilter(real_t weight) { derivativeWeight = (weight<=0 || weight>1 ? 1 : weight); }
+	//#endsubregion
 //#endregion
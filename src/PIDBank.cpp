@@ -0,0 +1,158 @@
+#include "PIDBank.h"  //also includes coreIncludes and cmath
+#include "scheduler.h"
+
+real_t PIDBank::kP[MAX_BANK_CONTROLLERS];
+real_t PIDBank::kI[MAX_BANK_CONTROLLERS];
+real_t PIDBank::kD[MAX_BANK_CONTROLLERS];
+real_t PIDBank::integralMax[MAX_BANK_CONTROLLERS];
+real_t PIDBank::outputMin[MAX_BANK_CONTROLLERS];
+real_t PIDBank::outputMax[MAX_BANK_CONTROLLERS];
+real_t PIDBank::target[MAX_BANK_CONTROLLERS];
+real_t PIDBank::input[MAX_BANK_CONTROLLERS];
+real_t PIDBank::output[MAX_BANK_CONTROLLERS];
+real_t PIDBank::integral[MAX_BANK_CONTROLLERS];
+real_t PIDBank::prevError[MAX_BANK_CONTROLLERS];
+PIDInput PIDBank::inputs[MAX_BANK_CONTROLLERS];
+PIDOutput PIDBank::outputs[MAX_BANK_CONTROLLERS];
+void* PIDBank::objects[MAX_BANK_CONTROLLERS];
+unsigned char PIDBank::usedMask;
+unsigned char PIDBank::activeMask;
+unsigned char PIDBank::freshMask;
+unsigned char PIDBank::count;
+unsigned short PIDBank::period = 10;
+TickTimer PIDBank::updateTimer;
+bool PIDBank::scheduled;
+
+static_assert(MAX_BANK_CONTROLLERS <= 8, "controller masks are 8 bits wide");
+
+char PIDBank::add(real_t kP, real_t kI, real_t kD, real_t integralMax, real_t outputMin, real_t outputMax, PIDInput input, PIDOutput output, void *object) {
+  for (unsigned char i=0; i<MAX_BANK_CONTROLLERS; i++) {
+    if (!(usedMask & (1 << i))) {
+      PIDBank::kP[i] = kP;
+      PIDBank::kI[i] = kI;
+      PIDBank::kD[i] = kD;
+      PIDBank::integralMax[i] = fabs(integralMax);
+      PIDBank::outputMin[i] = outputMin;
+      PIDBank::outputMax[i] = outputMax;
+      target[i] = 0;
+      PIDBank::input[i] = 0;
+      PIDBank::output[i] = 0;
+      inputs[i] = input;
+      outputs[i] = output;
+      objects[i] = object;
+      reset(i);
+      usedMask |= 1 << i;
+      activeMask &= ~(1 << i);
+      if (i >= count) count = i+1;
+      return i;
+    }
+  }
+
+  return -1;  //possible debug location
+}
+
+void PIDBank::remove(char id) {
+  if (valid(id)) {
+    usedMask &= ~(1 << id);
+    activeMask &= ~(1 << id);
+    while (count > 0 && !(usedMask & (1 << (count-1)))) count--;
+  }
+}
+
+void PIDBank::update(real_t timeStep) {
+  if (timeStep <= 0) timeStep = 1;
+  real_t inverseStep = 1 / timeStep; //one (software) division shared by every controller
+
+  for (unsigned char i=0; i<count; i++)  //gather inputs
+    if ((activeMask & (1 << i)) && inputs[i]) input[i] = inputs[i](objects[i]);
+
+  for (unsigned char i=0; i<count; i++) {
+    if (!(activeMask & (1 << i))) continue;
+
+    real_t error = target[i] - input[i];
+    real_t limitedError = (integralMax[i]==0 || fabs(error)<=integralMax[i]) ? error : copysign(integralMax[i], error);
+    real_t newIntegral = integral[i] + kI[i]*limitedError*timeStep;
+    real_t derivative = (freshMask & (1 << i)) ? 0 : kD[i]*(error - prevError[i])*inverseStep;
+    real_t unlimited = kP[i]*error + newIntegral + derivative;
+    real_t limited = fmin(fmax(unlimited, outputMin[i]), outputMax[i]);
+
+    if (limitedError*(unlimited - limited) <= 0) integral[i] = newIntegral; //conditional integration
+    output[i] = limited;
+    prevError[i] = error;
+  }
+
+  freshMask &= ~activeMask;
+
+  for (unsigned char i=0; i<count; i++)  //apply outputs
+    if ((activeMask & (1 << i)) && outputs[i]) outputs[i](objects[i], output[i]);
+}
+
+//#region background execution
+void PIDBank::runInBackground(unsigned short period) {
+  if (!scheduled && Scheduler::add(backgroundJob, NULL, period) >= 0) {
+    PIDBank::period = (period==0 ? 1 : period);
+    updateTimer.reset();
+    scheduled = true;
+  }
+}
+
+unsigned short PIDBank::getPeriod() { return period; }
+
+void PIDBank::backgroundJob(void *ignore) {
+  real_t timeStep = updateTimer.timeMicros() / (period * 1000.0);
+  updateTimer.reset();
+  update(timeStep);
+}
+//#endregion
+
+//#region controllers
+bool PIDBank::valid(char id) { return 0 <= id && id < MAX_BANK_CONTROLLERS && (usedMask & (1 << id)); }
+
+void PIDBank::setTarget(char id, real_t target) {
+  if (valid(id)) {
+    PIDBank::target[(unsigned char)id] = target;
+    reset(id);
+    activeMask |= 1 << id;
+  }
+}
+
+real_t PIDBank::getTarget(char id) { return (valid(id) ? target[(unsigned char)id] : 0); }
+
+void PIDBank::setActive(char id, bool active) {
+  if (valid(id)) {
+    if (active)
+      activeMask |= 1 << id;
+    else
+      activeMask &= ~(1 << id);
+  }
+}
+
+bool PIDBank::isActive(char id) { return valid(id) && (activeMask & (1 << id)); }
+
+void PIDBank::reset(char id) {
+  if (0 <= id && id < MAX_BANK_CONTROLLERS) {
+    integral[(unsigned char)id] = 0;
+    prevError[(unsigned char)id] = 0;
+    freshMask |= 1 << id;
+  }
+}
+
+void PIDBank::setInput(char id, real_t input) { if (valid(id)) PIDBank::input[(unsigned char)id] = input; }
+real_t PIDBank::getInput(char id) { return (valid(id) ? input[(unsigned char)id] : 0); }
+real_t PIDBank::getOutput(char id) { return (valid(id) ? output[(unsigned char)id] : 0); }
+
+void PIDBank::setCoeffs(char id, real_t kP, real_t kI, real_t kD) {
+  if (valid(id)) {
+    PIDBank::kP[(unsigned char)id] = kP;
+    PIDBank::kI[(unsigned char)id] = kI;
+    PIDBank::kD[(unsigned char)id] = kD;
+  }
+}
+
+void PIDBank::setOutputLimits(char id, real_t min, real_t max) {
+  if (valid(id)) {
+    outputMin[(unsigned char)id] = min;
+    outputMax[(unsigned char)id] = max;
+  }
+}
+//#endregion
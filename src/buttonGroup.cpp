@@ -7,9 +7,9 @@ char ButtonGroup::takeInput() {
   char power = 0;
 
   if (active) {
-    if (joystickGetDigital(upJoystick, upGroup, upButton))
+    if (ButtonTracker::isPressed(upGroup, upButton, upJoystick))
       power = upPower;
-    else if (joystickGetDigital(downJoystick, downGroup, downButton))
+    else if (ButtonTracker::isPressed(downGroup, downButton, downJoystick))
       power = downPower;
     else
       power = stillSpeed;
@@ -70,19 +70,19 @@ void ButtonGroup::configureMultiGroupInput(unsigned char upGroup, unsigned char
 }
 
 //#region constructors
-/*ButtonGroup::ButtonGroup(unsigned char numMotors, unsigned char motors[]) : MotorGroup(numMotors, motors) {
+/*ButtonGroup::ButtonGroup(unsigned char numMotors, const unsigned char motors[]) : MotorGroup(numMotors, motors) {
   active = false;
 }*/
 
-ButtonGroup::ButtonGroup(unsigned char buttonGroup, unsigned char numMotors, unsigned char motors[], char stillSpeed, unsigned char buttonConfig, char power, char downPower, unsigned char joystick) : MotorGroup(numMotors, motors) {
+ButtonGroup::ButtonGroup(unsigned char buttonGroup, unsigned char numMotors, const unsigned char motors[], char stillSpeed, unsigned char buttonConfig, char power, char downPower, unsigned char joystick) : MotorGroup(numMotors, motors) {
   configureInput(buttonGroup, stillSpeed, buttonConfig, power, downPower, joystick);
 }
 
-ButtonGroup::ButtonGroup(unsigned char numMotors, unsigned char motors[], unsigned char encPort1, unsigned char encPort2, double coeff) : MotorGroup(numMotors, motors, encPort1, encPort2, coeff) {
+ButtonGroup::ButtonGroup(unsigned char numMotors, const unsigned char motors[], unsigned char encPort1, unsigned char encPort2, real_t coeff) : MotorGroup(numMotors, motors, encPort1, encPort2, coeff) {
   active = false;
 }
 
-ButtonGroup::ButtonGroup(unsigned char numMotors, unsigned char motors[], unsigned char potPort, bool potReversed) : MotorGroup(numMotors, motors, potPort, potReversed) {
+ButtonGroup::ButtonGroup(unsigned char numMotors, const unsigned char motors[], unsigned char potPort, bool potReversed) : MotorGroup(numMotors, motors, potPort, potReversed) {
   active = false;
 }
 //#endregion
@@ -1,8 +1,42 @@
 #include "buttonTracker.h" //also includes config
 #include <API.h>
-#include <cmath>
 
-bool ButtonTracker::pressedButtons[NUM_JOYSTICKS][4][4];
+unsigned long ButtonTracker::current;
+unsigned long ButtonTracker::previous;
+unsigned long ButtonTracker::pressTimes[32];
+bool ButtonTracker::polled;
+
+void ButtonTracker::update() {
+	unsigned long mask = 0;
+
+	for (unsigned char joystick=1; joystick<=NUM_JOYSTICKS; joystick++) {
+		for (unsigned char group=5; group<=8; group++) {
+			for (unsigned char button=JOY_DOWN; button<=JOY_RIGHT; button <<= 1) {
+				if (group<7 && (button==JOY_LEFT || button==JOY_RIGHT))	//groups 5 and 6 have no left or right buttons
+					continue;
+				if (joystickGetDigital(joystick, group, button))
+					mask |= buttonBit(group, button, joystick);
+			}
+		}
+	}
+
+	update(mask);
+}
+
+void ButtonTracker::update(unsigned long mask) {
+	unsigned long pressed = mask & ~(polled ? current : 0);
+
+	if (pressed) {	//record press times (buttons held at first update are timed from then)
+		unsigned long now = millis();
+
+		for (unsigned char i=0; i<32; i++)
+			if (pressed & (1UL << i)) pressTimes[i] = now;
+	}
+
+	previous = (polled ? current : mask);	//nothing is newly pressed at first update
+	current = mask;
+	polled = true;
+}
 
 bool ButtonTracker::isValidButton(unsigned char buttonGroup, unsigned char button, unsigned char joystick) {
 	//possible debug location
@@ -12,14 +46,38 @@ bool ButtonTracker::isValidButton(unsigned char buttonGroup, unsigned char butto
 						&& ((buttonGroup==7 || buttonGroup==8) || (button==JOY_DOWN || button==JOY_UP));
 }
 
+bool ButtonTracker::isPressed(unsigned char buttonGroup, unsigned char button, unsigned char joystick) {
+	if (!isValidButton(buttonGroup, button, joystick)) return false;
+	if (!polled) return joystickGetDigital(joystick, buttonGroup, button);
+
+	return current & buttonBit(buttonGroup, button, joystick);
+}
+
 bool ButtonTracker::newlyPressed(unsigned char buttonGroup, unsigned char button, unsigned char joystick) {
-	if (isValidButton(buttonGroup, button, joystick)) {
-		bool newState = joystickGetDigital(joystick, buttonGroup, button);
-		bool oldState = pressedButtons[joystick-1][buttonGroup-5][(int) log2(button)];
-		pressedButtons[joystick-1][buttonGroup-5][(int) log2(button)] = newState;
+	return isValidButton(buttonGroup, button, joystick) && (newlyPressedMask() & buttonBit(buttonGroup, button, joystick));
+}
 
-		return newState && !oldState;	//(is pressed now) && (was not pressed at last update)
+bool ButtonTracker::released(unsigned char buttonGroup, unsigned char button, unsigned char joystick) {
+	return isValidButton(buttonGroup, button, joystick) && (releasedMask() & buttonBit(buttonGroup, button, joystick));
+}
+
+unsigned long ButtonTracker::heldDuration(unsigned char buttonGroup, unsigned char button, unsigned char joystick) {
+	if (isValidButton(buttonGroup, button, joystick) && polled) {
+		unsigned long bit = buttonBit(buttonGroup, button, joystick);
+
+		if (current & bit) {
+			unsigned char i = 0;
+			while (!(bit & (1UL << i))) i++;
+
+			return millis() - pressTimes[i];
+		}
 	}
 
-	return false;
+	return 0;
 }
+
+//#region masks
+unsigned long ButtonTracker::pressedMask() { return current; }
+unsigned long ButtonTracker::newlyPressedMask() { return current & ~previous; }
+unsigned long ButtonTracker::releasedMask() { return previous & ~current; }
+//#endregion
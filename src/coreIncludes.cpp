@@ -26,3 +26,65 @@ char sgn(double x) {
 	else
 		return fabs(x) / x;
 }
+
+//#region fast math
+static float reduceAngle(float x, int &k) {
+	//finds r in [-pi/2, pi/2] with x = r + k*pi (pi split in two for precision)
+	k = x * 0.318309886f + (x >= 0 ? 0.5f : -0.5f);
+	return (x - k*3.140625f) - k*9.67653589793e-4f;
+}
+
+static float sinPolynomial(float r) { //valid for r in [-pi/2, pi/2]
+	float r2 = r * r;
+	return r * (0.99999660f + r2*(-0.16664824f + r2*(0.00830629f + r2*-0.00018363f)));
+}
+
+float fastSin(float x) {
+	int k;
+	float result = sinPolynomial(reduceAngle(x, k));
+
+	return (k & 1 ? -result : result);
+}
+
+float fastCos(float x) {
+	int k;
+	float result = sinPolynomial(1.57079633f - fabsf(reduceAngle(x, k)));
+
+	return (k & 1 ? -result : result);
+}
+
+float fastAtan2(float y, float x) {
+	float absX = fabsf(x), absY = fabsf(y);
+
+	if (absX == 0 && absY == 0)
+		return 0;
+
+	//atan on [0, 1] (Abramowitz and Stegun 4.4.49)
+	float z = (absY <= absX ? absY/absX : absX/absY);
+	float z2 = z * z;
+	float angle = z * (0.9998660f + z2*(-0.3302995f + z2*(0.1801410f + z2*(-0.0851330f + z2*0.0208351f))));
+
+	if (absY > absX) angle = 1.57079633f - angle;
+	if (x < 0) angle = 3.14159265f - angle;
+
+	return (y < 0 ? -angle : angle);
+}
+
+float fastSqrt(float x) {
+	if (x <= 0)
+		return 0;
+
+	//initial estimate of 1/sqrt(x) from the exponent bits, refined with Newton's method
+	union { float f; unsigned int i; } bits = { x };
+	bits.i = 0x5f3759df - (bits.i >> 1);
+	float inverse = bits.f;
+	inverse *= 1.5f - 0.5f*x*inverse*inverse;
+	inverse *= 1.5f - 0.5f*x*inverse*inverse;
+
+	return x * inverse;
+}
+
+float fastHypot(float x, float y) {
+	return fastSqrt(x*x + y*y);
+}
+//#endregion
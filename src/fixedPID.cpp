@@ -0,0 +1,111 @@
+#include "fixedPID.h"
+
+real_t FixedPID::evaluate(real_t input) {
+  return fromFixed(evaluateFixed(toFixed(input)));
+}
+
+fixed FixedPID::evaluateFixed(fixed input) {
+  unsigned long elapsed = updateTimer.timeMicros();
+
+  if (elapsed > minSampleTime*1000ul) {
+    updateTimer.reset();
+    fixed error = saturate((int64_t)target - input);
+    fixed interval = (useTimeAdjustment ? saturate(((int64_t)elapsed << 16) / 1000) : FIXED_ONE); //milliseconds
+
+    fixed limitedError = error;
+    if (integralMax != 0 && (error > integralMax || error < -integralMax))
+      limitedError = (error < 0 ? -integralMax : integralMax);
+    /* Adds error if |error| < integralMax, otherwise add integralMax*sgn(error)
+        kI is factored in here to avoid problems when changing gain coeffs. */
+
+    fixed increment = fixedMul(kI, limitedError);
+    if (useTimeAdjustment) increment = fixedMul(increment, interval);
+    fixed newIntegral = saturate((int64_t)integral + increment);
+
+    fixed derivative = 0;
+
+    if (!firstSample) {
+      fixed change = saturate(derivativeOnMeasurement ? (int64_t)prevInput - input : (int64_t)error - prevError);  //the same unless target has changed
+      derivative = fixedMul(kD, change);
+      if (useTimeAdjustment) derivative = fixedDiv(derivative, interval);
+      if (derivativeWeight < FIXED_ONE) derivative = saturate((int64_t)prevDerivative + fixedMul(derivativeWeight, saturate((int64_t)derivative - prevDerivative)));
+    }
+
+    fixed output = saturate((int64_t)fixedMul(kP, error) + newIntegral + derivative);
+
+    if (outputMin < outputMax && (output < outputMin || output > outputMax)) { //saturated
+      fixed limited = (output < outputMin ? outputMin : outputMax);
+
+      if (antiWindup == CONDITIONAL_INTEGRATION && (limitedError < 0) == (output < outputMin) && limitedError != 0)  //integrating would push output further past limit
+        newIntegral = integral;
+      else if (antiWindup == BACK_CALCULATION)
+        newIntegral = saturate((int64_t)newIntegral + fixedMul(trackingGain, saturate((int64_t)limited - output)));
+
+      output = limited;
+    }
+
+    integral = newIntegral;
+    prevOutput = output;
+    prevError = error;
+    prevInput = input;
+    prevDerivative = derivative;
+    firstSample = false;
+  }
+
+  return prevOutput;
+}
+
+void FixedPID::reset() {
+  integral = 0;
+  prevError = 0;
+  prevDerivative = 0;
+  firstSample = true;
+  updateTimer.reset();
+}
+
+void FixedPID::changeTarget(real_t target) {
+  this->target = toFixed(target);
+  reset();
+}
+
+FixedPID::FixedPID(real_t target, real_t kP, real_t kI, real_t kD, unsigned short minSampleTime, real_t integralMax, bool useTimeAdjustment)
+          : target(toFixed(target)), kP(toFixed(kP)), kI(toFixed(kI)), kD(toFixed(kD)), minSampleTime(minSampleTime),
+            integralMax(toFixed(integralMax<0 ? -integralMax : integralMax)), useTimeAdjustment(useTimeAdjustment),
+            outputMin(0), outputMax(0), antiWindup(NO_ANTI_WINDUP), trackingGain(0), derivativeOnMeasurement(false), derivativeWeight(FIXED_ONE) {
+  integral = 0;
+  prevError = 0;
+  prevInput = 0;
+  prevDerivative = 0;
+  prevOutput = 0;
+  firstSample = true;
+}
+
+//#region accessors and mutators
+real_t FixedPID::get_kP() { return fromFixed(kP); }
+real_t FixedPID::get_kI() { return fromFixed(kI); }
+real_t FixedPID::get_kD() { return fromFixed(kD); }
+void FixedPID::setCoeffs(real_t kP, real_t kI, real_t kD) {
+  this->kP = toFixed(kP);
+  this->kI = toFixed(kI);
+  this->kD = toFixed(kD);
+}
+real_t FixedPID::getTarget() { return fromFixed(target); }
+real_t FixedPID::getIntegral() { return fromFixed(integral); }
+void FixedPID::setIntegral(real_t integral) { this->integral = toFixed(integral); }
+unsigned short FixedPID::getMinSampleTime() { return minSampleTime; }
+void FixedPID::setMinSampleTime(unsigned short minSampleTime) { this->minSampleTime = minSampleTime; }
+real_t FixedPID::getIntegralMax() { return fromFixed(integralMax); }
+void FixedPID::setIntegralMax(real_t max) { integralMax = toFixed(max<0 ? -max : max); }
+  //#subregion robustness options
+void FixedPID::setOutputLimits(real_t min, real_t max) {
+  outputMin = toFixed(min);
+  outputMax = toFixed(max);
+}
+void FixedPID::setAntiWindup(antiWindupType type, real_t trackingGain) {
+  antiWindup = type;
+  this->trackingGain = toFixed(trackingGain);
+}
+void FixedPID::setDerivativeOnMeasurement(bool onMeasurement) { derivativeOnMeasurement = onMeasurement; }
+void FixedPID::setDerivativeFilter(real_t weight) { derivativeWeight = (weight<=0 || weight>1 ? FIXED_ONE : toFixed(weight)); }
+  //#endsubregion
+//#endregion
@@ -0,0 +1,34 @@
+#include "fixedPoint.h"
+
+fixed fixedExp(fixed x) {
+  const fixed LN2 = 45426;  //ln(2) in Q16.16
+
+  if (x > 681391) return FIXED_MAX;  //e^x > 32767
+  if (x < -772243) return 0;         //e^x < 1/65536
+
+  //e^x = 2^n * e^r, where r is in [0, ln2)
+  int n = x / LN2;
+  fixed r = x - n*LN2;
+
+  if (r < 0) {
+    n--;
+    r += LN2;
+  }
+
+  //7th-order Taylor series of e^r, evaluated with Horner's method in Q2.30 for precision
+  int64_t r30 = (int64_t)r << 14;
+  int64_t result = (1 << 30) + r30/7;
+  result = (1 << 30) + ((result * r30) >> 30) / 6;
+  result = (1 << 30) + ((result * r30) >> 30) / 5;
+  result = (1 << 30) + ((result * r30) >> 30) / 4;
+  result = (1 << 30) + ((result * r30) >> 30) / 3;
+  result = (1 << 30) + ((result * r30) >> 30) / 2;
+  result = (1 << 30) + ((result * r30) >> 30);
+
+  //convert from Q2.30 to Q16.16 and apply 2^n
+  int shift = 14 - n;
+  if (shift > 0)
+    return (result + (1LL << (shift - 1))) >> shift;
+  else
+    return saturate(result << -shift);
+}
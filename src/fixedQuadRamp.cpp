@@ -0,0 +1,24 @@
+#include "fixedQuadRamp.h"
+#include "coreIncludes.h" //also includes cmath
+
+FixedQuadRamp::FixedQuadRamp(real_t target, real_t initial, real_t maximum, real_t end) {
+  double a = ((end + initial - 2*maximum) - 2*sqrt((end-maximum) * (initial-maximum))) / pow(target, 2);
+
+  //use as many fractional bits as a allows
+  for (aShift=30; aShift>16 && fabs(a) * (1 << aShift) >= INT32_MAX; aShift--);
+  this->a = a * (1 << aShift);
+
+  b = ((end-initial)/target - a*target) * sgn(target) * 4294967296.0;
+  c = toFixed(initial);
+}
+
+real_t FixedQuadRamp::evaluate(real_t input) {
+  return fromFixed(evaluateFixed(toFixed(input)));
+}
+
+fixed FixedQuadRamp::evaluateFixed(fixed input) {
+  int64_t slope = (((int64_t)a * input) >> (aShift-16)) + b; //a*x + b, scaled by 2^32 (Horner's method: (a*x + b)*x + c)
+  int64_t whole = ((slope >> 16) * input) >> 16;            //multiplied in two parts, so the product can't overflow
+  int64_t fraction = ((slope & 0xFFFF) * input) >> 32;
+  return saturate(whole + fraction + c);
+}
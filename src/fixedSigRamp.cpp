@@ -0,0 +1,21 @@
+#include "fixedSigRamp.h"
+#include <cmath>
+
+FixedSigRamp::FixedSigRamp(real_t k, real_t M, real_t intercept) {
+  double C = 2 * M / intercept - 1;
+  double s = log((2*M/(M+intercept) - 1) / C) / (k * 2*M);
+
+  kM2 = toFixed(k * 2*M);
+  M2 = toFixed(2*M);
+  this->C = toFixed(C);
+  this->s = toFixed(s);
+}
+
+real_t FixedSigRamp::evaluate(real_t input) {
+  return fromFixed(evaluateFixed(toFixed(input)));
+}
+
+fixed FixedSigRamp::evaluateFixed(fixed input) {
+  fixed e = fixedExp(-fixedMul(kM2, saturate((int64_t)input + s)));
+  return fixedDiv(M2, saturate((int64_t)FIXED_ONE + fixedMul(C, e)));
+}
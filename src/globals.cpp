@@ -1,10 +1,7 @@
 #include "config.h"
 
 //drive
-unsigned char leftMotors[] = LD_MPS;
-unsigned char rightMotors[] = RD_MPS;
-ParallelDrive drive(sizeof(leftMotors), sizeof(rightMotors), leftMotors, rightMotors);  //unsigned chars are 1 byte, so sizeof() == number of elements
+ParallelDrive drive(LeftDrivePorts::count, RightDrivePorts::count, LeftDrivePorts::list, RightDrivePorts::list);
 
 //flapper
-unsigned char flapperMotors[] = FLAPPER_MPS;
-ButtonGroup flapper(FLAPPER_GROUP, sizeof(flapperMotors), flapperMotors);
+ButtonGroup flapper(FLAPPER_GROUP, FlapperPorts::count, FlapperPorts::list);
@@ -0,0 +1,31 @@
+#include "heapGuard.h"
+#include <API.h>
+
+bool HeapGuard::locked = false;
+bool HeapGuard::reporting = false;
+unsigned int HeapGuard::violationCount = 0;
+
+void HeapGuard::lock() { locked = true; }
+void HeapGuard::unlock() { locked = false; }
+bool HeapGuard::isLocked() { return locked; }
+unsigned int HeapGuard::violations() { return violationCount; }
+
+void HeapGuard::allocated(size_t size) {
+  if (locked && !reporting) {
+    reporting = true;
+    violationCount++;
+    printf("HeapGuard: %u byte allocation after startup\n", (unsigned int)size); //possible debug location
+    reporting = false;
+  }
+}
+
+#ifndef SIMULATION
+extern "C" {
+  void* __real_malloc(size_t size);
+
+  void* __wrap_malloc(size_t size) {  //see -Wl,--wrap=malloc in common.mk
+    HeapGuard::allocated(size);
+    return __real_malloc(size);
+  }
+}
+#endif
@@ -0,0 +1,98 @@
+#include "holonomicDrive.h"  //also includes coreIncludes, cmath, and API
+#include "sensorCache.h"
+#include "profiler.h"
+
+//#region main methods
+void HolonomicDrive::takeInput() {
+  PROFILE_SCOPE(PROFILE_HOLONOMIC_INPUT);
+
+  real_t x = inputCurve.map(SensorCache::joystickAnalog(xAxis, joystick));
+  real_t y = inputCurve.map(SensorCache::joystickAnalog(yAxis, joystick));
+  real_t turn = inputCurve.map(SensorCache::joystickAnalog(turnAxis, joystick));
+
+  setDrivePowerByVector(x, y, turn, fieldCentric);
+}
+
+void HolonomicDrive::setDrivePower(char leftFront, char rightFront, char leftBack, char rightBack) {
+  wheels[LEFT_FRONT].setPower(leftFront);
+  wheels[RIGHT_FRONT].setPower(rightFront);
+  wheels[LEFT_BACK].setPower(leftBack);
+  wheels[RIGHT_BACK].setPower(rightBack);
+}
+
+void HolonomicDrive::setDrivePowerByVector(real_t x, real_t y, real_t turn, bool fieldRelative) {
+  if (fieldRelative && hasGyro()) { //rotate <x, y> from field frame into robot frame
+    bam heading = degreesToBam(SensorCache::gyro(gyroPort));
+    real_t s = bamSin(heading), c = bamCos(heading);
+    real_t robotX = x*c + y*s;
+
+    y = y*c - x*s;
+    x = robotX;
+  }
+
+  real_t powers[4] = { y + x + turn,    //left front
+                       y - x - turn,    //right front
+                       y - x + turn,    //left back
+                       y + x - turn };  //right back
+  real_t max = 127;
+
+  for (unsigned char i=0; i<4; i++)
+    if (fabs(powers[i]) > max) max = fabs(powers[i]);
+
+  real_t scale = 127 / max;
+  setDrivePower(powers[0]*scale, powers[1]*scale, powers[2]*scale, powers[3]*scale);
+}
+
+void HolonomicDrive::setDrivePowerByAngle(real_t angle, real_t magnitude, real_t turn, angleType format, bool fieldRelative) {
+  angle = convertAngle(angle, format, RADIANS);
+  setDrivePowerByVector(magnitude*controlCos(angle), magnitude*controlSin(angle), turn, fieldRelative);
+}
+//#endregion
+
+//#region constructors
+HolonomicDrive::HolonomicDrive(unsigned char leftFront, unsigned char rightFront, unsigned char leftBack, unsigned char rightBack, unsigned char xAxis, unsigned char yAxis, unsigned char turnAxis, unsigned char deadband, unsigned char joystick)
+                              : wheels{ {1, &leftFront}, {1, &rightFront}, {1, &leftBack}, {1, &rightBack} }, fieldCentric(false), gyroPort(0) {
+  configureInput(xAxis, yAxis, turnAxis, deadband, joystick);
+}
+//#endregion
+
+//#region input config
+void HolonomicDrive::configureInput(unsigned char xAxis, unsigned char yAxis, unsigned char turnAxis, unsigned char deadband, unsigned char joystick, real_t coeff, real_t powMap) {
+  this->xAxis = xAxis;
+  this->yAxis = yAxis;
+  this->turnAxis = turnAxis;
+  this->joystick = joystick;
+  inputCurve.configure(coeff, powMap, deadband);
+
+  SensorCache::addJoystickAxis(xAxis, joystick);
+  SensorCache::addJoystickAxis(yAxis, joystick);
+  SensorCache::addJoystickAxis(turnAxis, joystick);
+}
+
+void HolonomicDrive::setFieldCentric(bool fieldCentric) { this->fieldCentric = fieldCentric; }
+bool HolonomicDrive::isFieldCentric() { return fieldCentric; }
+//#endregion
+
+//#region sensors
+void HolonomicDrive::addSensor(unsigned char gyroPort, unsigned short multiplier) {
+  gyro = gyroInit(gyroPort, multiplier);
+  this->gyroPort = gyroPort;
+  SensorCache::addGyro(gyroPort, gyro);
+}
+
+real_t HolonomicDrive::gyroVal(angleType format) {
+  if (hasGyro())
+    return convertAngle(SensorCache::gyro(gyroPort), DEGREES, format);
+
+  return 0; //possible debug location
+}
+
+void HolonomicDrive::resetGyro() {
+  if (hasGyro())  //possible debug location
+    SensorCache::resetGyro(gyroPort);
+}
+
+bool HolonomicDrive::hasGyro() { return gyroPort; }
+//#endregion
+
+MotorGroup* HolonomicDrive::wheel(wheelPosition position) { return &wheels[position]; }
@@ -1,5 +1,8 @@
 #include "main.h"
 #include "config.h"
+#include "scheduler.h"
+#include "heapGuard.h"
+#include "telemetry.h"
 
 extern "C" {
   void __libc_init_array();
@@ -10,14 +13,26 @@ void initializeIO() {
 }
 
 void initialize() {
+  //#region motor config
+  drive.usePorts<LeftDrivePorts, RightDrivePorts>();
+  flapper.usePorts<FlapperPorts>();
+  //#endregion
   //#region sensor config
   drive.addSensor(HYRO);
-  drive.addSensor(LEFT_ENC, LEFT, WHEEL_DIAMETER);
-  drive.addSensor(RIGHT_ENC, RIGHT);
+  drive.addSensor(LEFT_ENC_TOP, LEFT_ENC_BOTTOM, LEFT_ENC_REVERSED, LEFT, DRIVE_WHEEL);
+  drive.addSensor(RIGHT_ENC_TOP, RIGHT_ENC_BOTTOM, RIGHT_ENC_REVERSED, RIGHT, DRIVE_WHEEL);
 
   flapper.addSensor(FLAPPER_POT, true);
   //#endregion
   //#region PID config
   flapper.posPIDinit(0.2, 0.001, 0.03);
   //#endregion
+  //#region background control
+  drive.runInBackground();
+  flapper.runInBackground();
+  Scheduler::start();
+  Telemetry::start(); //does nothing unless TELEMETRY_LEVEL is set in common.mk
+  //#endregion
+
+  HeapGuard::lock();  //nothing should allocate from here on
 }
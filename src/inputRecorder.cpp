@@ -0,0 +1,236 @@
+#include "inputRecorder.h"  //also includes sensorCache and API
+#include "coreIncludes.h"
+
+#define AXES_CHANGED 0x08
+#define BUTTONS_CHANGED 0x01
+#define LEFT_CHANGED 0x02
+#define RIGHT_CHANGED 0x04
+
+unsigned char InputRecorder::buffer[RECORDING_BUFFER_SIZE];
+unsigned int InputRecorder::bufferLength;
+bool InputRecorder::recording;
+bool InputRecorder::playing;
+bool InputRecorder::full;
+unsigned char InputRecorder::encPorts[2];
+signed char InputRecorder::lastAxes[CACHE_NUM_JOYSTICKS][6];
+unsigned long InputRecorder::lastButtons;
+int InputRecorder::lastCounts[2];
+unsigned char InputRecorder::run;
+const unsigned char* InputRecorder::stream;
+unsigned int InputRecorder::streamLength;
+unsigned int InputRecorder::position;
+unsigned char InputRecorder::repeats;
+int InputRecorder::startCounts[2];
+real_t InputRecorder::kP = 0.5;
+
+//#region recording
+void InputRecorder::startRecording(unsigned char leftEncPort, unsigned char rightEncPort) {
+  stopPlayback();
+
+  encPorts[0] = leftEncPort;
+  encPorts[1] = rightEncPort;
+  bufferLength = 0;
+  run = 0;
+  full = false;
+  recording = true;
+
+  write('R');
+  write(leftEncPort);
+  write(rightEncPort);
+
+  //first tick is encoded relative to a neutral state
+  for (unsigned char j=0; j<CACHE_NUM_JOYSTICKS; j++)
+    for (unsigned char i=0; i<6; i++) lastAxes[j][i] = 0;
+  lastButtons = 0;
+
+  for (unsigned char side=0; side<2; side++)
+    lastCounts[side] = SensorCache::encoder(encPorts[side]);
+}
+
+void InputRecorder::stopRecording() {
+  if (recording) {
+    flushRun();
+    recording = false;
+  }
+}
+
+bool InputRecorder::isRecording() { return recording; }
+bool InputRecorder::overflowed() { return full; }
+unsigned int InputRecorder::length() { return bufferLength; }
+
+void InputRecorder::dump() {
+  printf("//%u bytes\n", bufferLength);
+
+  for (unsigned int i=0; i<bufferLength; i++)
+    printf("0x%02x,%c", buffer[i], (i%16==15 || i==bufferLength-1) ? '\n' : ' ');
+}
+
+void InputRecorder::record(const SensorSnapshot &values, unsigned long buttons) {
+  if (!recording) return;
+
+  //find changes
+  unsigned short axisMask = 0;
+  unsigned char flags = 0;
+  int deltas[2];
+
+  for (unsigned char j=0; j<CACHE_NUM_JOYSTICKS; j++)
+    for (unsigned char i=0; i<6; i++)
+      if (values.axes[j][i] != lastAxes[j][i]) axisMask |= 1 << (6*j + i);
+
+  for (unsigned char side=0; side<2; side++) {
+    deltas[side] = limit(SensorCache::encoder(encPorts[side]) - lastCounts[side], -32767, 32767);  //any remainder is carried into the next tick
+    if (deltas[side] != 0) flags |= (side==0 ? LEFT_CHANGED : RIGHT_CHANGED);
+  }
+
+  if (axisMask) flags |= AXES_CHANGED;
+  if (buttons != lastButtons) flags |= BUTTONS_CHANGED;
+
+  if (flags == 0) { //unchanged tick
+    if (++run == 0x80) flushRun();
+    return;
+  }
+
+  //write changes
+  unsigned int start = bufferLength;
+  flushRun();
+  bool ok = write(0x80 | flags);
+
+  if (flags & AXES_CHANGED) {
+    ok = ok && write(axisMask) && write(axisMask >> 8);
+
+    for (unsigned char j=0; j<CACHE_NUM_JOYSTICKS; j++)
+      for (unsigned char i=0; i<6; i++)
+        if (axisMask & (1 << (6*j + i))) ok = ok && write(values.axes[j][i]);
+  }
+
+  if (flags & BUTTONS_CHANGED) {
+    unsigned long changes = buttons ^ lastButtons;
+    for (unsigned char i=0; i<4; i++) ok = ok && write(changes >> (8*i));
+  }
+
+  for (unsigned char side=0; side<2; side++)
+    if (flags & (side==0 ? LEFT_CHANGED : RIGHT_CHANGED))
+      ok = ok && write(deltas[side]) && write(deltas[side] >> 8);
+
+  if (!ok) {  //buffer full, so discard partial tick and stop
+    bufferLength = start;
+    recording = false;
+    return;
+  }
+
+  for (unsigned char j=0; j<CACHE_NUM_JOYSTICKS; j++)
+    for (unsigned char i=0; i<6; i++) lastAxes[j][i] = values.axes[j][i];
+  lastButtons = buttons;
+  lastCounts[0] += deltas[0];
+  lastCounts[1] += deltas[1];
+}
+
+bool InputRecorder::write(unsigned char byte) {
+  if (bufferLength >= RECORDING_BUFFER_SIZE) {
+    full = true;  //possible debug location
+    return false;
+  }
+
+  buffer[bufferLength++] = byte;
+  return true;
+}
+
+void InputRecorder::flushRun() {
+  if (run > 0) {
+    if (!write(run-1)) recording = false;
+    run = 0;
+  }
+}
+//#endregion
+
+//#region playback
+void InputRecorder::startPlayback(const unsigned char *stream, unsigned int length) {
+  stopRecording();
+
+  if (!stream) {
+    stream = buffer;
+    length = bufferLength;
+  }
+
+  if (length < 3 || stream[0] != 'R') return; //possible debug location
+
+  InputRecorder::stream = stream;
+  streamLength = length;
+  encPorts[0] = stream[1];
+  encPorts[1] = stream[2];
+  position = 3;
+  repeats = 0;
+
+  for (unsigned char j=0; j<CACHE_NUM_JOYSTICKS; j++)
+    for (unsigned char i=0; i<6; i++) lastAxes[j][i] = 0;
+  lastButtons = 0;
+
+  for (unsigned char side=0; side<2; side++) {
+    lastCounts[side] = 0;
+    startCounts[side] = SensorCache::encoder(encPorts[side]);
+  }
+
+  playing = true;
+}
+
+void InputRecorder::stopPlayback() { playing = false; }
+bool InputRecorder::isPlaying() { return playing; }
+void InputRecorder::setCorrection(real_t kP) { InputRecorder::kP = kP; }
+
+int InputRecorder::driftCorrection(unsigned char side) {
+  if (!playing || side > 1 || encPorts[side] == 0) return 0;
+
+  int actual = SensorCache::encoder(encPorts[side]) - startCounts[side];
+  return kP * (lastCounts[side] - actual);
+}
+
+void InputRecorder::play(SensorSnapshot &values, unsigned long &buttons) {
+  if (!playing) return;
+
+  if (repeats > 0) {
+    repeats--;
+  } else if (position >= streamLength) {  //end of recording, so return to neutral input
+    for (unsigned char j=0; j<CACHE_NUM_JOYSTICKS; j++)
+      for (unsigned char i=0; i<6; i++) lastAxes[j][i] = 0;
+    lastButtons = 0;
+    playing = false;
+  } else {
+    unsigned char token = read();
+
+    if (token < 0x80) {
+      repeats = token;  //this tick is the first of token+1
+    } else {
+      if (token & AXES_CHANGED) {
+        unsigned short axisMask = read();
+        axisMask |= read() << 8;
+
+        for (unsigned char j=0; j<CACHE_NUM_JOYSTICKS; j++)
+          for (unsigned char i=0; i<6; i++)
+            if (axisMask & (1 << (6*j + i))) lastAxes[j][i] = read();
+      }
+
+      if (token & BUTTONS_CHANGED) {
+        unsigned long changes = 0;
+        for (unsigned char i=0; i<4; i++) changes |= (unsigned long)read() << (8*i);
+        lastButtons ^= changes;
+      }
+
+      for (unsigned char side=0; side<2; side++) {
+        if (token & (side==0 ? LEFT_CHANGED : RIGHT_CHANGED)) {
+          short delta = read();
+          delta |= read() << 8;
+          lastCounts[side] += delta;
+        }
+      }
+    }
+  }
+
+  for (unsigned char j=0; j<CACHE_NUM_JOYSTICKS; j++)
+    for (unsigned char i=0; i<6; i++) values.axes[j][i] = lastAxes[j][i];
+  buttons = lastButtons;
+}
+
+unsigned char InputRecorder::read() {
+  return position < streamLength ? stream[position++] : 0;  //possible debug location
+}
+//#endregion
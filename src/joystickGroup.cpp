@@ -1,5 +1,6 @@
 #include "joystickGroup.h"
 #include "timer.h"
+#include "sensorCache.h"
 #include <cmath>
 #include <API.h>
 
@@ -7,10 +8,7 @@ char JoystickGroup::takeInput() {
 	char power = 0;
 
   if (active) {
-  	char input = joystickGetAnalog(joystick, axis);
-  	power = coeff * copysign(127 * pow(input / 127.0, powMap), input);
-
-  	if (abs(power) < deadband) power = 0;
+  	power = curve.map(SensorCache::joystickAnalog(axis, joystick));
 
   	//handle ramping
   	if (ramping) { //TODO: create better ramping scheme?
@@ -39,14 +37,13 @@ char JoystickGroup::takeInput() {
 	return power;
 }
 
-void JoystickGroup::configureInput(unsigned char axis, double coeff, double powMap, unsigned char maxAcc100ms, unsigned char deadband, unsigned char joystick) {
+void JoystickGroup::configureInput(unsigned char axis, real_t coeff, real_t powMap, unsigned char maxAcc100ms, unsigned char deadband, unsigned char joystick) {
   active = true;
 
   this->joystick = joystick;
   this->axis = axis;
-  this->coeff = coeff;
-  this->powMap = powMap;
-  this->deadband = deadband;
+  curve.configure(coeff, powMap, deadband);
+  SensorCache::addJoystickAxis(axis, joystick);
 
   if (maxAcc100ms == 0) {
     ramping = false;
@@ -58,19 +55,19 @@ void JoystickGroup::configureInput(unsigned char axis, double coeff, double powM
 }
 
 //#region constructors
-JoystickGroup::JoystickGroup(unsigned char numMotors, unsigned char motors[]) : MotorGroup(numMotors, motors) {
+JoystickGroup::JoystickGroup(unsigned char numMotors, const unsigned char motors[]) : MotorGroup(numMotors, motors) {
   active = false;
 }
 
-JoystickGroup::JoystickGroup(unsigned char numMotors, unsigned char axis, unsigned char motors[], double coeff, double powMap, unsigned char maxAcc100ms, unsigned char deadband, unsigned char joystick) : MotorGroup(numMotors, motors) {
+JoystickGroup::JoystickGroup(unsigned char numMotors, unsigned char axis, const unsigned char motors[], real_t coeff, real_t powMap, unsigned char maxAcc100ms, unsigned char deadband, unsigned char joystick) : MotorGroup(numMotors, motors) {
   configureInput(axis, coeff, powMap, maxAcc100ms, deadband, joystick);
 }
 
-JoystickGroup::JoystickGroup(unsigned char numMotors, unsigned char motors[], unsigned char encPort1, unsigned char encPort2, double coeff) : MotorGroup(numMotors, motors, encPort1, encPort2, coeff) {
+JoystickGroup::JoystickGroup(unsigned char numMotors, const unsigned char motors[], unsigned char encPort1, unsigned char encPort2, real_t coeff) : MotorGroup(numMotors, motors, encPort1, encPort2, coeff) {
   active = false;
 }
 
-JoystickGroup::JoystickGroup(unsigned char numMotors, unsigned char motors[], unsigned char potPort, bool potReversed) : MotorGroup(numMotors, motors, potPort, potReversed) {
+JoystickGroup::JoystickGroup(unsigned char numMotors, const unsigned char motors[], unsigned char potPort, bool potReversed) : MotorGroup(numMotors, motors, potPort, potReversed) {
   active = false;
 }
 //#endregion
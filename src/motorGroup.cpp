@@ -1,7 +1,13 @@
 #include "motorGroup.h"		//also includes API
 #include "coreIncludes.h"	//also includes cmath
 #include "PID.h"
-#include "Timer.h"
+#include "fixedPID.h"
+#include "PIDBank.h"
+#include "timer.h"
+#include "sensorCache.h"
+#include "scheduler.h"
+#include "telemetry.h"
+#include "profiler.h"
 
 void MotorGroup::setPower(char power, bool overrideAbsolutes) {
 	/*if (!overrideAbsolutes) {
@@ -12,8 +18,14 @@ void MotorGroup::setPower(char power, bool overrideAbsolutes) {
 			power = defPowerAtAbs;
 	}*/
 
-	for (unsigned char motor=0; motor<numMotors; motor++)
-	  motorSet(motors[motor], power);
+	if (writeMotors) {
+		writeMotors(power);
+	} else {
+		for (unsigned char motor=0; motor<numMotors; motor++)
+		  motorSet(motors[motor], power);
+	}
+
+	TELEMETRY_COUNTS(3, TELEMETRY_MOTORS, motors[0], power);
 }
 
 char MotorGroup::getPower() {
@@ -21,52 +33,68 @@ char MotorGroup::getPower() {
 }
 
 //#region constructors
-MotorGroup::MotorGroup(unsigned char numMotors, unsigned char motors[]) : numMotors(numMotors), motors(motors) {
-	maneuverTimer = new Timer;
+MotorGroup::MotorGroup(unsigned char numMotors, const unsigned char motors[])
+												: numMotors(numMotors<MAX_GROUP_MOTORS ? numMotors : MAX_GROUP_MOTORS), writeMotors(NULL), hasAbsMax(false), hasAbsMin(false), maneuverExecuting(false),
+													posPID(0, 0, 0, 0), hasPosPID(false), bankId(-1), targetingActive(false), encoder(NULL), encPort(0), encCoeff(1), encoderZero(0), potPort(0), potReversed(false), potIsDefault(false), scheduled(false) {
+	for (unsigned char i=0; i<this->numMotors; i++)	//possible debug location (if numMotors > MAX_GROUP_MOTORS)
+		this->motors[i] = motors[i];
 }
 
-MotorGroup::MotorGroup(unsigned char numMotors, unsigned char motors[], unsigned char encPort1, unsigned char encPort2, double coeff)
-												: numMotors(numMotors), motors(motors), encCoeff(fabs(coeff)) {
-	maneuverTimer = new Timer;
-	encoder = encoderInit(encPort1, encPort2, coeff<0);
+MotorGroup::MotorGroup(unsigned char numMotors, const unsigned char motors[], unsigned char encPort1, unsigned char encPort2, real_t coeff) : MotorGroup(numMotors, motors) {
+	addSensor(encPort1, encPort2, coeff, false);
 }
 
-MotorGroup::MotorGroup(unsigned char numMotors, unsigned char motors[], unsigned char potPort, bool potReversed)
-												: numMotors(numMotors), motors(motors), potPort(potPort), potReversed(potReversed) {
-	maneuverTimer = new Timer;
+MotorGroup::MotorGroup(unsigned char numMotors, const unsigned char motors[], unsigned char potPort, bool potReversed) : MotorGroup(numMotors, motors) {
+	addSensor(potPort, potReversed, false);
 }
 //#endregion
 
 //#region sensors
-void MotorGroup::addSensor(unsigned char encPort1, unsigned char encPort2, double coeff, bool setAsDefault) {
+void MotorGroup::addSensor(unsigned char encPort1, unsigned char encPort2, real_t coeff, bool setAsDefault) {
 	encoder = encoderInit(encPort1, encPort2, coeff<0);
+	encPort = encPort1;
 	encCoeff = fabs(coeff);
 	encoderReset(encoder);
+	encoderZero = 0;
+	SensorCache::addEncoder(encPort, encoder);
 	if (setAsDefault) potIsDefault = false;
 }
 
 void MotorGroup::addSensor(unsigned char potPort, bool reversed, bool setAsDefault) {
 	this->potPort = potPort;
 	potReversed = reversed;
+	SensorCache::addAnalog(potPort);
 	if (setAsDefault) potIsDefault = true;
 }
 
 int MotorGroup::encoderVal(bool rawValue) {
 	if (hasEncoder()) {
-		return encoderGet(encoder) * (rawValue ? 1 : encCoeff);
+		return (SensorCache::encoder(encPort) - encoderZero) * (rawValue ? 1 : encCoeff);
 	}
 
 	return 0;	//possible debug location
 }
 
 void MotorGroup::resetEncoder() {
-	while (fabs(encoderVal()) > 0)	//I'm terrible
-		encoderReset(encoder);
-}	//possible debug location
+	encoderZero = encoderCount();
+}
+
+int MotorGroup::encoderCount() {
+	return hasEncoder() ? SensorCache::encoder(encPort) : 0;	//possible debug location
+}
+
+real_t MotorGroup::encoderDelta(int &count, bool rawValue) {
+	int newCount = encoderCount();
+	int delta = newCount - count;
+	count = newCount;
+
+	return delta * (rawValue ? 1 : encCoeff);
+}
 
 int MotorGroup::potVal() {
 	if (hasPotentiometer()) {
-		return potReversed ? 4095-analogRead(potPort) : analogRead(potPort);
+		int value = SensorCache::analog(potPort);
+		return potReversed ? 4095-value : value;
 	} else {
 		return 0;	//possible debug location
 	}
@@ -92,11 +120,13 @@ void MotorGroup::stopManeuver() {
 }
 
 void MotorGroup::executeManeuver() {
+	PROFILE_SCOPE(PROFILE_GROUP_MANEUVER);
+
 	if (maneuverExecuting) {
 		if (forward == (getPosition() < maneuverTarget)) {
-			maneuverTimer->reset();
+			maneuverTimer.reset();
 			setPower(maneuverPower);
-		} else if (maneuverTimer->time() > maneuverTimeout) {
+		} else if (maneuverTimer.time() > maneuverTimeout) {
 			maneuverExecuting = false;
 			setPower(endPower);
 		}
@@ -105,41 +135,182 @@ void MotorGroup::executeManeuver() {
 
 void MotorGroup::goToPosition(int pos, bool runAsManeuver, char endPower, char maneuverPower, unsigned short timeout) {
 	maneuverTarget = pos;
-	endPower = endPower;
+	this->endPower = endPower;
 	forward = maneuverTarget > getPosition();
-	maneuverPower = copysign(maneuverPower, (forward ? 1 : -1));
-	maneuverExecuting = true;
+	this->maneuverPower = copysign(maneuverPower, (forward ? 1 : -1));
 	maneuverTimeout = timeout;
-	maneuverTimer->reset();
+	maneuverTimer.reset();
+	maneuverExecuting = true;	//set last, since executeManeuver() may be running in the background
 
 	if (!runAsManeuver) {
-		while (maneuverExecuting) executeManeuver();
+		while (maneuverExecuting) {
+			if (runningInBackground()) {
+				delay(Scheduler::getTickPeriod());
+			} else {
+				SensorCache::refresh();
+				executeManeuver();
+			}
+		}
 	}
 }
 
 	//#subregion position targeting
-void MotorGroup::posPIDinit(double kP, double kI, double kD, unsigned short minSampleTime, double integralMax, bool useTimeAdjustment) {
-	posPID = new PID(0, kP, kI, kD, minSampleTime, integralMax, useTimeAdjustment);
+void MotorGroup::posPIDinit(real_t kP, real_t kI, real_t kD, unsigned short minSampleTime, real_t integralMax, bool useTimeAdjustment) {
+	posPID = ControlPID(0, kP, kI, kD, minSampleTime, integralMax, useTimeAdjustment);
+	posPID.setOutputLimits(-127, 127);
+	posPID.setAntiWindup(CONDITIONAL_INTEGRATION);
+	hasPosPID = true;
+}
+
+ControlPID& MotorGroup::getPosPID() { return posPID; }
+
+bool MotorGroup::posPIDinitInBank(real_t kP, real_t kI, real_t kD, real_t integralMax) {
+	if (bankId < 0)
+		bankId = PIDBank::add(kP, kI, kD, integralMax, -127, 127, bankInput, bankOutput, this);
+	else
+		PIDBank::setCoeffs(bankId, kP, kI, kD);
+
+	if (bankId >= 0) PIDBank::runInBackground();	//does nothing if bank job is already registered
+
+	return bankId >= 0;
 }
 
 void MotorGroup::setTargetPosition(int position) {
-	posPID->changeTarget(position);
+	if (bankId >= 0)
+		PIDBank::setTarget(bankId, position);
+	else
+		posPID.changeTarget(position);
+
 	targetingActive = true;
 }
 
+real_t MotorGroup::bankInput(void *group) {
+	return static_cast<MotorGroup*>(group)->getPosition();
+}
+
+void MotorGroup::bankOutput(void *group, real_t power) {
+	MotorGroup *self = static_cast<MotorGroup*>(group);
+
+	if (self->targetingActive && !self->maneuverExecuting) {
+		self->setPower(power);
+		TELEMETRY_LOG(2, TELEMETRY_CONTROLLER, self->motors[0], PIDBank::getTarget(self->bankId), PIDBank::getInput(self->bankId), power);
+	}
+}
+
 void MotorGroup::maintainTargetPos() {
-	if (targetingActive && posPID) {
-		setPower(posPID->evaluate(getPosition()));
+	PROFILE_SCOPE(PROFILE_GROUP_TARGET);
+
+	if (targetingActive && hasPosPID && bankId < 0) {
+		int position = getPosition();
+		char power = posPID.evaluate(position);
+
+		setPower(power);
+		TELEMETRY_LOG(2, TELEMETRY_CONTROLLER, motors[0], posPID.getTarget(), position, power);
+	}
+}
+
+AutotuneResult MotorGroup::autotunePosPID(int setpoint, tuningRule rule, char relayPower, int hysteresis, unsigned char cycles, unsigned short timeout) {
+	AutotuneResult result = { false, 0, 0, 0, 0, 0 };
+	TickTimer testTimer;
+	unsigned long lastSwitchUp = 0;
+	unsigned char switchesUp = 0, measured = 0;
+	real_t amplitudeSum = 0, periodSum = 0;
+	int peakMax = getPosition(), peakMin = peakMax;
+	bool high = getPosition() < setpoint;
+
+	stopManeuver();
+	deactivatePositionTargeting();	//keeps background job from setting power
+	setPower(high ? relayPower : -relayPower);
+
+	while (measured < cycles && testTimer.time() < timeout) {
+		delay(5);
+		SensorCache::refresh();
+		int position = getPosition();
+
+		if (position > peakMax) peakMax = position;
+		if (position < peakMin) peakMin = position;
+
+		if (high && position > setpoint+hysteresis) {
+			high = false;
+			setPower(-relayPower);
+		} else if (!high && position < setpoint-hysteresis) {	//end of a full cycle
+			high = true;
+			setPower(relayPower);
+
+			if (switchesUp >= 2) {	//first cycle (which starts away from setpoint) is skipped
+				periodSum += testTimer.timeMicros() - lastSwitchUp;
+				amplitudeSum += (peakMax - peakMin) / 2.0;
+				measured++;
+			}
+
+			switchesUp++;
+			lastSwitchUp = testTimer.timeMicros();
+			peakMax = peakMin = position;
+		}
+	}
+
+	setPower(0);
+
+	if (measured < cycles) return result;	//possible debug location
+
+	real_t amplitude = amplitudeSum / measured;
+	result.ultimatePeriod = periodSum / measured / 1000;
+	result.ultimateGain = 4 * relayPower / (PI * sqrt(fmax(amplitude*amplitude - hysteresis*hysteresis, 1)));
+
+	real_t integralTime, derivativeTime;	//milliseconds
+
+	if (rule == TYREUS_LUYBEN) {
+		result.kP = result.ultimateGain / 2.2;
+		integralTime = 2.2 * result.ultimatePeriod;
+		derivativeTime = result.ultimatePeriod / 6.3;
+	} else {
+		result.kP = 0.6 * result.ultimateGain;
+		integralTime = result.ultimatePeriod / 2;
+		derivativeTime = result.ultimatePeriod / 8;
 	}
+
+	result.kI = result.kP / integralTime;
+	result.kD = result.kP * derivativeTime;
+	result.success = true;
+
+	if (bankId >= 0)
+		PIDBank::setCoeffs(bankId, result.kP, result.kI * PIDBank::getPeriod(), result.kD / PIDBank::getPeriod());
+	else
+		posPIDinit(result.kP, result.kI, result.kD, fmax(result.ultimatePeriod/10, 5), 0, true);	//rules assume sampling much faster than Tu
+
+	setTargetPosition(setpoint);
+	return result;
 }
 
 bool MotorGroup::errorLessThan(int margin) {
-	return abs(posPID->getTarget() - getPosition()) < margin;
+	real_t target = (bankId >= 0 ? PIDBank::getTarget(bankId) : posPID.getTarget());
+	return fabs(target - getPosition()) < margin;
+}
+	//#endsubregion
+	//#subregion background execution
+void MotorGroup::runInBackground(unsigned short period) {
+	if (!scheduled && Scheduler::add(backgroundJob, this, period) >= 0)
+		scheduled = true;
+}
+
+bool MotorGroup::runningInBackground() {
+	return scheduled && Scheduler::isRunning();
+}
+
+void MotorGroup::backgroundJob(void *group) {
+	MotorGroup *self = static_cast<MotorGroup*>(group);
+
+	if (self->maneuverExecuting)
+		self->executeManeuver();
+	else
+		self->maintainTargetPos();
 }
 	//#endsubregion
 //#endregion
 
 //#region accessors and mutators
+unsigned char MotorGroup::getMotor(unsigned char index) { return motors[index<numMotors ? index : 0]; }
+
 	//#subregion sensors
 bool MotorGroup::isPotReversed() { return potReversed; }
 void MotorGroup::setPotReversed(bool reversed) { potReversed = reversed; }
@@ -151,8 +322,14 @@ bool MotorGroup::hasPotentiometer() { return potPort; }
 	//#endsubregion
 	//#subregion automovement
 bool MotorGroup::isManeuverExecuting() { return maneuverExecuting; }
-void MotorGroup::activatePositionTargeting() { targetingActive = true; }
-void MotorGroup::deactivatePositionTargeting() { targetingActive = false; }
+void MotorGroup::activatePositionTargeting() {
+	targetingActive = true;
+	PIDBank::setActive(bankId, true);	//does nothing unless controller is in bank
+}
+void MotorGroup::deactivatePositionTargeting() {
+	targetingActive = false;
+	PIDBank::setActive(bankId, false);
+}
 	//#endsubregion
 	//#subregion position limits
 void MotorGroup::setAbsMin(int min, char defPowerAtAbs, char maxPowerAtAbs) {
@@ -1,24 +1,28 @@
 #include "main.h"
 #include "config.h"	//also includes parallelDrive and buttonGroup
 #include "buttonTracker.h"
+#include "sensorCache.h"
 
 
 void operatorControl() {
 	int prevPos = 2000;
 
 	while (true) {
+		SensorCache::update();
+
 		//flapper.takeInput();
-		flapper.maintainTargetPos();
-		drive.takeInput();
+		drive.takeInput();	//flapper's target position is maintained by the Scheduler
 
 		if (ButtonTracker::newlyPressed(7, JOY_UP)) {
 			prevPos = flapper.getPosition();
 			printf("%d", prevPos);
 		}
 
-		if (joystickGetDigital(1, 7, JOY_DOWN)) {
+		if (ButtonTracker::isPressed(7, JOY_DOWN)) {
 			flapper.setTargetPosition(prevPos);
 		}
+
+		delay(20);
 	}
 }
 
@@ -2,123 +2,137 @@
 #include "joystickGroup.h"
 #include "PID.h"
 #include "quadRamp.h"
+#include "fixedPID.h"
+#include "fixedQuadRamp.h"
 #include "timer.h"
+#include "sensorCache.h"
+#include "scheduler.h"
+#include "inputRecorder.h"
+#include "telemetry.h"
+#include "profiler.h"
+#include <new>
 
 DriveDefaults dDefs;
 TurnDefaults tDefs;
+PursuitDefaults pDefs;
+TrajectoryDefaults trDefs;
 
 void ParallelDrive::takeInput() {
+  PROFILE_SCOPE(PROFILE_DRIVE_INPUT);
+  int left, right;
+
   if (arcadeInput) {
-    char moveVal = coeff * joystickGetAnalog(joystick, moveAxis);
-    char turnVal = coeff * joystickGetAnalog(joystick, turnAxis);
+    int moveVal = arcadeCurve.map(SensorCache::joystickAnalog(moveAxis, joystick));
+    int turnVal = arcadeCurve.map(SensorCache::joystickAnalog(turnAxis, joystick));
 
-    setDrivePower(moveVal+turnVal, moveVal-turnVal);
+    left = limit(moveVal+turnVal, -127, 127);
+    right = limit(moveVal-turnVal, -127, 127);
   } else {
-    leftDrive->takeInput();
-    rightDrive->takeInput();
+    left = leftDrive.takeInput();
+    right = rightDrive.takeInput();
+  }
+
+  if (InputRecorder::isPlaying()) { //steer back toward recorded encoder positions
+    left = limit(left + InputRecorder::driftCorrection(0), -127, 127);
+    right = limit(right + InputRecorder::driftCorrection(1), -127, 127);
   }
+
+  if (arcadeInput || InputRecorder::isPlaying()) setDrivePower(left, right);
 }
 
 //#region power setting
-void ParallelDrive::setLeftPower(char power) { leftDrive->setPower(power); }
-void ParallelDrive::setRightPower(char power) { rightDrive->setPower(power); }
+void ParallelDrive::setLeftPower(char power) { leftDrive.setPower(power); }
+void ParallelDrive::setRightPower(char power) { rightDrive.setPower(power); }
 void ParallelDrive::setDrivePower(char left, char right) {
-  leftDrive->setPower(left);
-  rightDrive->setPower(right);
+  leftDrive.setPower(left);
+  rightDrive.setPower(right);
 }
 //#endregion
 
 //#region constructors
-ParallelDrive::ParallelDrive(unsigned char numMotorsL, unsigned char numMotorsR, unsigned char leftMotors[], unsigned char rightMotors[], unsigned char lEncPort1, unsigned char lEncPort2, bool lReversed, unsigned char rEncPort1, unsigned char rEncPort2, bool rReversed, double wheelDiameter, double gearRatio)
-                              : wheelDiameter(wheelDiameter) {
-  double coeff = PI * wheelDiameter * gearRatio / 360.0;
-
-  leftDrive = new JoystickGroup(numMotorsL, leftMotors, lEncPort1, lEncPort2, coeff * (lReversed ? -1.0 : 1.0));
-  rightDrive = new JoystickGroup(numMotorsR, rightMotors, rEncPort1, rEncPort2, coeff * (rReversed ? -1.0 : 1.0));
+ParallelDrive::ParallelDrive(unsigned char numMotorsL, unsigned char numMotorsR, const unsigned char leftMotors[], const unsigned char rightMotors[], unsigned char lEncPort1, unsigned char lEncPort2, bool lReversed, unsigned char rEncPort1, unsigned char rEncPort2, bool rReversed, real_t wheelDiameter, real_t gearRatio)
+                              : leftDrive(numMotorsL, leftMotors, lEncPort1, lEncPort2, encoderCoefficient(wheelDiameter, gearRatio) * (lReversed ? -1.0 : 1.0)),
+                                rightDrive(numMotorsR, rightMotors, rEncPort1, rEncPort2, encoderCoefficient(wheelDiameter, gearRatio) * (rReversed ? -1.0 : 1.0)),
+                                wheelDiameter(wheelDiameter), encConfig(UNASSIGNED), gyro(NULL), gyroPort(0), angleOffset(0), xPos(0), yPos(0), orientation(0), maneuverPhase(RAMPING), isTurning(false), isDriving(false), correctionPID(0, 0, 0, 0), scheduled(false) {
   updateEncConfig();
 
-  positionTimer = new Timer;
-  sampleTimer = new Timer;
-  moveTimer = new Timer;
-
   initializeDefaults();
 }
 
-ParallelDrive::ParallelDrive(unsigned char numMotorsL, unsigned char numMotorsR, unsigned char leftMotors[], unsigned char rightMotors[], double coeff, double powMap, unsigned char maxAcc100ms, unsigned char deadband, unsigned char leftAxis, unsigned char rightAxis, unsigned char joystick) {
-  leftDrive = new JoystickGroup(numMotorsL, leftMotors);
-  rightDrive = new JoystickGroup(numMotorsR, rightMotors);
-
+ParallelDrive::ParallelDrive(unsigned char numMotorsL, unsigned char numMotorsR, const unsigned char leftMotors[], const unsigned char rightMotors[], real_t coeff, real_t powMap, unsigned char maxAcc100ms, unsigned char deadband, unsigned char leftAxis, unsigned char rightAxis, unsigned char joystick)
+                              : leftDrive(numMotorsL, leftMotors), rightDrive(numMotorsR, rightMotors), encConfig(UNASSIGNED), gyro(NULL), gyroPort(0), angleOffset(0), xPos(0), yPos(0), orientation(0), maneuverPhase(RAMPING), isTurning(false), isDriving(false), correctionPID(0, 0, 0, 0), scheduled(false) {
   configureTankInput(coeff, powMap, maxAcc100ms, deadband, leftAxis, rightAxis, joystick);
 
-  positionTimer = new Timer;
-  sampleTimer = new Timer;
-  moveTimer = new Timer;
-
   initializeDefaults();
 }
 
-ParallelDrive::ParallelDrive(unsigned char movementAxis, unsigned char turningAxis, unsigned char numMotorsL, unsigned char numMotorsR, unsigned char leftMotors[], unsigned char rightMotors[], double coeff) {
-  leftDrive = new JoystickGroup(numMotorsL, leftMotors);
-  rightDrive = new JoystickGroup(numMotorsR, rightMotors);
-
+ParallelDrive::ParallelDrive(unsigned char movementAxis, unsigned char turningAxis, unsigned char numMotorsL, unsigned char numMotorsR, const unsigned char leftMotors[], const unsigned char rightMotors[], real_t coeff)
+                              : leftDrive(numMotorsL, leftMotors), rightDrive(numMotorsR, rightMotors), encConfig(UNASSIGNED), gyro(NULL), gyroPort(0), angleOffset(0), xPos(0), yPos(0), orientation(0), maneuverPhase(RAMPING), isTurning(false), isDriving(false), correctionPID(0, 0, 0, 0), scheduled(false) {
   configureArcadeInput(movementAxis, turningAxis, coeff);
 
-  positionTimer = new Timer;
-  sampleTimer = new Timer;
-  moveTimer = new Timer;
-
   initializeDefaults();
 }
 //#endregion
 
 //#region input configuration
-void ParallelDrive::configureTankInput(double coeff, double powMap, unsigned char maxAcc100ms, unsigned char deadband, unsigned char leftAxis, unsigned char rightAxis, unsigned char joystick) {
-  leftDrive->configureInput(leftAxis, coeff, powMap, maxAcc100ms, deadband, joystick);
-  rightDrive->configureInput(rightAxis, coeff, powMap, maxAcc100ms, deadband, joystick);
+void ParallelDrive::configureTankInput(real_t coeff, real_t powMap, unsigned char maxAcc100ms, unsigned char deadband, unsigned char leftAxis, unsigned char rightAxis, unsigned char joystick) {
+  leftDrive.configureInput(leftAxis, coeff, powMap, maxAcc100ms, deadband, joystick);
+  rightDrive.configureInput(rightAxis, coeff, powMap, maxAcc100ms, deadband, joystick);
   arcadeInput = false;
 }
 
-void ParallelDrive::configureArcadeInput(unsigned char movementAxis, unsigned char turningAxis, double coeff) {
+void ParallelDrive::configureArcadeInput(unsigned char movementAxis, unsigned char turningAxis, real_t coeff, unsigned char joystick, real_t powMap, unsigned char deadband) {
   moveAxis = movementAxis;
   turnAxis = turningAxis;
-  this->coeff = coeff;
+  arcadeCurve.configure(coeff, powMap, deadband);
+  this->joystick = joystick;
   arcadeInput = true;
+
+  SensorCache::addJoystickAxis(moveAxis, joystick);
+  SensorCache::addJoystickAxis(turnAxis, joystick);
 }
 //#endregion
 
 //#region sensors
-void ParallelDrive::addSensor(unsigned char encPort1, unsigned char encPort2, bool reversed, encoderConfig side, double wheelDiameter, double gearRatio) {
+void ParallelDrive::addSensor(unsigned char encPort1, unsigned char encPort2, bool reversed, encoderConfig side, real_t wheelDiameter, real_t gearRatio) {
   if (wheelDiameter == 0) {
     if (this->wheelDiameter != 0) {
       wheelDiameter = this->wheelDiameter;
     } else {
       wheelDiameter = 3.25; //possible debug location
     }
-  } else {
-    this->wheelDiameter = wheelDiameter;
   }
 
-  double coeff = PI * wheelDiameter * gearRatio / 360.0 * (reversed ? -1.0 : 1.0);
+  addSensor(encPort1, encPort2, reversed, side, DriveWheel(wheelDiameter, gearRatio));
+}
+
+void ParallelDrive::addSensor(unsigned char encPort1, unsigned char encPort2, bool reversed, encoderConfig side, const DriveWheel &wheel) {
+  wheelDiameter = wheel.diameter;
+  real_t coeff = (reversed ? -wheel.encCoeff : wheel.encCoeff);
 
   if (side == LEFT) {
-    leftDrive->addSensor(encPort1, encPort2, coeff);
+    leftDrive.addSensor(encPort1, encPort2, coeff);
   } else if (side == RIGHT) {
-    rightDrive->addSensor(encPort1, encPort2, coeff);
-  } else if (leftDrive->hasEncoder()) {
-    rightDrive->addSensor(encPort1, encPort2, coeff);
+    rightDrive.addSensor(encPort1, encPort2, coeff);
+  } else if (leftDrive.hasEncoder()) {
+    rightDrive.addSensor(encPort1, encPort2, coeff);
   } else {
-    leftDrive->addSensor(encPort1, encPort2, coeff); //possible debug location (if both encoders are attached)
+    leftDrive.addSensor(encPort1, encPort2, coeff); //possible debug location (if both encoders are attached)
   }
 
+  leftPositionCount = leftDrive.encoderCount();
+  rightPositionCount = rightDrive.encoderCount();
   updateEncConfig();
 }
 
 void ParallelDrive::addSensor(unsigned char gyroPort, gyroCorrectionType correction, unsigned short multiplier) {
   gyro = gyroInit(gyroPort, multiplier);
+  this->gyroPort = gyroPort;
   gyroCorrection = correction;
+  SensorCache::addGyro(gyroPort, gyro);
 }
 
-double ParallelDrive::encoderVal(encoderConfig side, bool rawValue, bool absolute) {
+real_t ParallelDrive::encoderVal(encoderConfig side, bool rawValue, bool absolute) {
   if (side == UNASSIGNED)
 		side = encConfig;
 
@@ -129,42 +143,56 @@ double ParallelDrive::encoderVal(encoderConfig side, bool rawValue, bool absolut
 			return (encoderVal(LEFT, rawValue) + encoderVal(RIGHT, rawValue)) / 2;
 		}
 	} else if (side == LEFT) {
-		return leftDrive->encoderVal(rawValue);
+		return leftDrive.encoderVal(rawValue);
 	} else {
-		return rightDrive->encoderVal(rawValue);
+		return rightDrive.encoderVal(rawValue);
 	}
 }
 
+real_t ParallelDrive::combineSides(real_t left, real_t right, encoderConfig side, bool absolute) {
+  if (side == UNASSIGNED)
+    side = encConfig;
+
+  if (side == AVERAGE)
+    return (absolute ? fabs(left) + fabs(right) : left + right) / 2;
+  else
+    return (side == LEFT ? left : right);
+}
+
 void ParallelDrive::resetEncoders() {
-    leftDrive->resetEncoder();
-    rightDrive->resetEncoder();
+    leftDrive.resetEncoder();
+    rightDrive.resetEncoder();
 }
 
-double ParallelDrive::gyroVal(angleType format) {
+real_t ParallelDrive::gyroVal(angleType format) {
   if (hasGyro())
-    return convertAngle(gyroGet(gyro), DEGREES, format);
+    return convertAngle(SensorCache::gyro(gyroPort), DEGREES, format);
 
   return 0; //possible debug location
 }
 
 void ParallelDrive::resetGyro() {
-  angleOffset += gyroVal();
+  angleOffset = absHeading();
 
   if (hasGyro())  //possible debug location
-    return gyroReset(gyro);
+    return SensorCache::resetGyro(gyroPort);
 }
 
-double ParallelDrive::absAngle(angleType format) {
-  return gyroVal() + convertAngle(angleOffset, DEGREES, format);
+real_t ParallelDrive::absAngle(angleType format) {
+  return fromBam(absHeading(), format);
+}
+
+bam ParallelDrive::absHeading() {
+  return angleOffset + degreesToBam(SensorCache::gyro(gyroPort)); //gyro() returns 0 if there is no gyro
 }
 
 void ParallelDrive::updateEncConfig() {
-  if (leftDrive->hasEncoder()) {
-    if (rightDrive->hasEncoder())
+  if (leftDrive.hasEncoder()) {
+    if (rightDrive.hasEncoder())
       encConfig = AVERAGE;
     else
       encConfig = LEFT;
-  } else if (rightDrive->hasEncoder()) {
+  } else if (rightDrive.hasEncoder()) {
     encConfig = RIGHT;
   } else {
     encConfig = UNASSIGNED;
@@ -174,17 +202,17 @@ void ParallelDrive::updateEncConfig() {
 
 //#region position tracking
 void ParallelDrive::updatePosition() {
-  if (positionTimer->time() >= minSampleTime && width != 0) {
-		double leftDist = encoderVal(LEFT);
-		double rightDist = encoderVal(RIGHT);
-		double angle = absAngle(RADIANS);
+  if (positionTimer.time() >= minSampleTime && width != 0) {
+		PROFILE_SCOPE(PROFILE_ODOMETRY);
+		real_t leftDist = leftDrive.encoderDelta(leftPositionCount);
+		real_t rightDist = rightDrive.encoderDelta(rightPositionCount);
+		bam angle = absHeading();
 
-		resetEncoders();
-		positionTimer->reset();
+		positionTimer.reset();
 
 		if (gyroCorrection == FULL && rightDist+leftDist != 0) {
-			double deltaT = angle - orientation;
-			double correctionFactor = (rightDist - leftDist - width*deltaT) / (rightDist + leftDist);
+			real_t deltaT = fromBam(angle - orientation, RADIANS);
+			real_t correctionFactor = (rightDist - leftDist - width*deltaT) / (rightDist + leftDist);
 			leftDist *= 1 + correctionFactor;
 			rightDist *= 1 - correctionFactor;
 		}
@@ -193,20 +221,25 @@ void ParallelDrive::updatePosition() {
 			float r = width / (rightDist/leftDist - 1.0) + width/2;
 			float phi = (rightDist - leftDist) / width;
 
-			xPos += r * (sin(orientation + phi) - sin(orientation));
-			yPos += r * (cos(orientation) - cos(orientation + phi));
-			orientation = (gyroCorrection==NO ? orientation+phi : angle);
+			bam newOrientation = orientation + toBam(phi, RADIANS);
+
+			xPos += r * (bamSin(newOrientation) - bamSin(orientation));
+			yPos += r * (bamCos(orientation) - bamCos(newOrientation));
+			orientation = (gyroCorrection==NO ? newOrientation : angle);
 		} else {
-			xPos += leftDist * cos(orientation);
-			yPos += leftDist * sin(orientation);
+			xPos += leftDist * bamCos(orientation);
+			yPos += leftDist * bamSin(orientation);
 		}
+
+		TELEMETRY_LOG(1, TELEMETRY_POSE, leftDrive.getMotor(), xPos, yPos, fromBam(orientation, DEGREES));
+		TELEMETRY_LOG(2, TELEMETRY_ODOMETRY, leftDrive.getMotor(), leftDist, rightDist);
 	}
 }
 
-double ParallelDrive::calculateWidth(unsigned short duration, unsigned short sampleTime, char power, unsigned short reverseDelay) {
+real_t ParallelDrive::calculateWidth(unsigned short duration, unsigned short sampleTime, char power, unsigned short reverseDelay) {
   if (hasGyro() && encConfig != UNASSIGNED) {
 		Timer widthTimer;
-		double totalWidth = 0;
+		real_t totalWidth = 0;
 		unsigned short samples = 0;
 
 		for (char i=1; i>=0; i--) { //turn both directions
@@ -218,6 +251,7 @@ double ParallelDrive::calculateWidth(unsigned short duration, unsigned short sam
 				resetEncoders();
 				resetGyro();
 				delay(sampleTime);
+				SensorCache::refresh();
 
 				totalWidth += fabs(encoderVal() / gyroVal(RADIANS));
 				samples++;
@@ -231,61 +265,69 @@ double ParallelDrive::calculateWidth(unsigned short duration, unsigned short sam
 //#endregion
 
 //#region automovement
-void ParallelDrive::turn(double angle, bool runAsManeuver, double rc1, double rc2, double rc3, double rc4, double rc5, angleType format, unsigned short waitAtEnd, unsigned short sampleTime, char brakePower, unsigned short brakeDuration, bool useGyro) {
+void ParallelDrive::turn(real_t angle, bool runAsManeuver, real_t rc1, real_t rc2, real_t rc3, real_t rc4, real_t rc5, angleType format, unsigned short waitAtEnd, unsigned short sampleTime, char brakePower, unsigned short brakeDuration, bool useGyro) {
   //initialize variables
   if (reverseTurns) angle *= -1;
-	double formattedAngle = convertAngle(angle, format, DEGREES);
+	real_t formattedAngle = convertAngle(angle, format, DEGREES);
 	target = (useGyro ? formattedAngle : formattedAngle*PI*width/180.0/wheelDiameter); //possible debug location (if not all variables are initialized)
 	finalDelay = waitAtEnd;
   this->sampleTime = sampleTime;
+	this->brakePower = brakePower;
 	brakeDelay = brakeDuration;
+	maneuverPhase = RAMPING;
 	usingGyro = useGyro;
-	isTurning = true;
+	leftManeuverCount = leftDrive.encoderCount();
+	rightManeuverCount = rightDrive.encoderCount();
 
   if (rc4 == 0) {
-    ramp = new QuadRamp(target, rc1, rc2, rc3);
+    ramp = new (&rampSlot.quadRamp) ControlQuadRamp(target, rc1, rc2, rc3);
     quadRamping = true;
   } else {
-    ramp = new PID(target, rc1, rc5, rc2);
+    ramp = new (&rampSlot.pid) ControlPID(target, rc1, rc5, rc2);
     margin = convertAngle(rc3, format, DEGREES);
     timeout = rc4;
     quadRamping = false;
-    maneuverTimer->reset();
+    maneuverTimer.reset();
   }
 
 	resetGyro();
+	isTurning = true;  //set last, as a scheduled executeManeuver() may run at any point after this
 
-	if (!runAsManeuver) {
-		while (isTurning)
-			executeManeuver();
-	}
+	if (!runAsManeuver) waitForManeuver();
 }
 
-void ParallelDrive::drive(double dist, bool runAsManeuver, double rc1, double rc2, double rc3, double rc4, double rc5, unsigned short waitAtEnd, double kP, double kI, double kD, correctionType correction, bool rawValue, double minSpeed, unsigned short moveTimeout, char brakePower, unsigned short brakeDuration, unsigned short sampleTime) {
+void ParallelDrive::drive(real_t dist, bool runAsManeuver, real_t rc1, real_t rc2, real_t rc3, real_t rc4, real_t rc5, unsigned short waitAtEnd, real_t kP, real_t kI, real_t kD, correctionType correction, bool rawValue, real_t minSpeed, unsigned short moveTimeout, char brakePower, unsigned short brakeDuration, unsigned short sampleTime) {
+  startDrive(dist, runAsManeuver, rc1, rc2, rc3, rc4, rc5, waitAtEnd, kP, kI, kD, correction, rawValue, minSpeed, moveTimeout, brakePower, brakeDuration, sampleTime, 1, 1);
+}
+
+void ParallelDrive::startDrive(real_t dist, bool runAsManeuver, real_t rc1, real_t rc2, real_t rc3, real_t rc4, real_t rc5, unsigned short waitAtEnd, real_t kP, real_t kI, real_t kD, correctionType correction, bool rawValue, real_t minSpeed, unsigned short moveTimeout, char brakePower, unsigned short brakeDuration, unsigned short sampleTime, real_t leftScale, real_t rightScale) {
   //initialize variables
 	target = dist;
 	this->rawValue = rawValue;
-	minSpeed = minSpeed * sampleTime / 1000;
+	this->minSpeed = minSpeed * sampleTime / 1000;
 	this->moveTimeout = moveTimeout;
-  brakeDelay = limit(0, brakeDuration, waitAtEnd);
-	finalDelay = waitAtEnd - brakeDuration;
+	this->brakePower = brakePower;
+  brakeDelay = limit(brakeDuration, 0, waitAtEnd);
+	finalDelay = waitAtEnd - brakeDelay;
+	maneuverPhase = RAMPING;
 	this->sampleTime = sampleTime;
-	isDriving = true;
-	correctionPID = new PID(0, kP, kI, kD);
+	correctionPID = ControlPID(0, kP, kI, kD);
 
 	leftDist = 0;
 	rightDist = 0;
 	totalDist = 0;
+	this->leftScale = leftScale;
+	this->rightScale = rightScale;
 
   if (rc4 == 0) {
-    ramp = new QuadRamp(target, rc1, rc2, rc3);
+    ramp = new (&rampSlot.quadRamp) ControlQuadRamp(target, rc1, rc2, rc3);
     quadRamping = true;
   } else {
-    ramp = new PID(target, rc1, rc5, rc2);
+    ramp = new (&rampSlot.pid) ControlPID(target, rc1, rc5, rc2);
     margin = rc3;
     timeout = rc4;
     quadRamping = false;
-    maneuverTimer->reset();
+    maneuverTimer.reset();
   }
 
   if (correction == NONE)
@@ -296,105 +338,151 @@ void ParallelDrive::drive(double dist, bool runAsManeuver, double rc1, double rc
 		setCorrectionType(ENCODER);
 
 	//initialize sensors
-	resetEncoders();
-	sampleTimer->reset();
-  moveTimer->reset();
+	leftManeuverCount = leftDrive.encoderCount();
+	rightManeuverCount = rightDrive.encoderCount();
+	sampleTimer.reset();
+  moveTimer.reset();
+  isDriving = true;  //see turn()
 
-  if (!runAsManeuver) {
-    while (isDriving)
-      executeManeuver();
-  }
+  if (!runAsManeuver) waitForManeuver();
 }
 
 void ParallelDrive::executeManeuver() { //TODO: break up into smaller functions
-  if (isDriving && sampleTimer->time() >= sampleTime) {  //driving
-    if (moveTimer->time() >= moveTimeout) {  //timed out due to lack of movement
+  PROFILE_SCOPE(PROFILE_DRIVE_MANEUVER);
+
+  if (maneuverPhase != RAMPING) { //braking or waiting at end of maneuver
+    if (maneuverExecuting()) updateEndPhase();
+  }
+  else if (isDriving && sampleTimer.time() >= sampleTime) {  //driving
+    if (moveTimer.time() >= moveTimeout) {  //timed out due to lack of movement
       setDrivePower(0, 0);
       isDriving = false;
+      clearQueue();
     }
     else if (!maneuverFinished()) {  //continue driving
       //update distances
-      leftDist += fabs(encoderVal(LEFT, rawValue));
-  	  rightDist += fabs(encoderVal(RIGHT, rawValue));
+      real_t leftDelta = leftDrive.encoderDelta(leftManeuverCount, rawValue);
+      real_t rightDelta = rightDrive.encoderDelta(rightManeuverCount, rawValue);
+      leftDist += fabs(leftDelta);
+  	  rightDist += fabs(rightDelta);
   	  totalDist = (leftDist + rightDist) / 2;
 
       //update timers
-      sampleTimer->reset();
-      if (encoderVal() >= minSpeed) moveTimer->reset();
-      if (!quadRamping && fabs(totalDist - target) > margin) maneuverTimer->reset();
-
-      resetEncoders();
+      sampleTimer.reset();
+      if (combineSides(leftDelta, rightDelta) >= minSpeed) moveTimer.reset();
+      if (!quadRamping && fabs(totalDist - target) > margin) maneuverTimer.reset();
 
     	//calculate error value and correction coefficient
-    	double error;
+    	real_t error;
 
     	switch (correction) {
     		case ENCODER:
-    			error = rightDist - leftDist;
+    			error = rightDist*leftScale - leftDist*rightScale; //rightDist - leftDist unless following an arc
     			break;
     		case GYRO:
-    			error = sin(gyroVal(RADIANS)) * totalDist; //not sure if this is the right approach, but...
+    			error = bamSin(degreesToBam(SensorCache::gyro(gyroPort))) * totalDist; //not sure if this is the right approach, but...
     			break;
     		default:
     			error = 0;
       }
 
       int power = ramp->evaluate(totalDist);
+      lastPower = power;
 
-      double correctionPercent = 1 + correctionPID->evaluate(error);
-      double rightPower = power * correctionPercent;
-      double leftPower = power;
+      real_t correctionPercent = 1 + correctionPID.evaluate(error);
+      real_t rightPower = power * rightScale * correctionPercent;
+      real_t leftPower = power * leftScale;
+      real_t maxPower = fmax(fabs(leftPower), fabs(rightPower));
 
-      if (rightPower > 127) {
-        rightPower = 127;
-        leftPower = 127 / (correctionPercent);
+      if (maxPower > 127) {
+        leftPower *= 127 / maxPower;
+        rightPower *= 127 / maxPower;
       }
 
       setDrivePower(sgn(target)*leftPower, sgn(target)*rightPower);
+      TELEMETRY_LOG(2, TELEMETRY_CONTROLLER, leftDrive.getMotor(), target, totalDist, power);
     }
-    else {  //end maneuver - TAKES TIME! Expect a delay unless this is wrapped in a task
-      if (quadRamping) {  //brake
-      	setDrivePower(-sgn(target)*brakePower, -sgn(target)*brakePower);
-      	delay(brakeDelay);
-      }
-
-      setDrivePower(0, 0);
-    	delay(finalDelay);
-    	isDriving = false;
+    else if (!nextSegment()) {
+      beginEndPhase(-sgn(target)*brakePower, -sgn(target)*brakePower);
     }
   }
   else if (isTurning) { //turning
     if (!maneuverFinished()) {
-      double progress = maneuverProgress();
+      real_t progress = maneuverProgress();
 
       if (!quadRamping && fabs(progress - target) > margin) //track timeout state
-        maneuverTimer->reset();
+        maneuverTimer.reset();
 
       char power = ramp->evaluate(progress);
 
       setDrivePower(sgn(target)*power, -sgn(target)*power);
+      TELEMETRY_LOG(2, TELEMETRY_CONTROLLER, leftDrive.getMotor(), target, progress, power);
     }
-    else {  //end maneuver - TAKES TIME! Expect a delay unless this is wrapped in a task
-      if (quadRamping) {  //brake
-      	setDrivePower(-sgn(target)*brakePower, sgn(target)*brakePower);
-      	delay(brakeDelay);
-      }
+    else if (!nextSegment()) {
+      beginEndPhase(-sgn(target)*brakePower, sgn(target)*brakePower);
+    }
+  }
+  else if (isFollowing) {
+    if (trajectory)
+      followTrajectoryUpdate();
+    else
+      followPathUpdate();
+  }
+}
 
-      setDrivePower(0, 0);
-    	delay(finalDelay);
-    	isTurning = false;
+void ParallelDrive::beginEndPhase(char leftBrakePower, char rightBrakePower) {
+  if (quadRamping && brakeDelay > 0) {
+    setDrivePower(leftBrakePower, rightBrakePower);
+    maneuverPhase = BRAKING;
+  } else {
+    setDrivePower(0, 0);
+    maneuverPhase = SETTLING;
+  }
+
+  phaseTimer.reset();
+  updateEndPhase(); //finishes immediately if there is no delay
+}
+
+void ParallelDrive::updateEndPhase() {
+  if (maneuverPhase == BRAKING && phaseTimer.time() >= brakeDelay) {
+    setDrivePower(0, 0);
+    maneuverPhase = SETTLING;
+    phaseTimer.reset();
+  }
+
+  if (maneuverPhase == SETTLING && phaseTimer.time() >= finalDelay) {
+    isDriving = false;
+    isTurning = false;
+    isFollowing = false;
+    maneuverPhase = RAMPING;
+    clearQueue();
+  }
+}
+
+void ParallelDrive::waitForManeuver() {
+  while (maneuverExecuting()) {
+    if (runningInBackground()) {
+      delay(Scheduler::getTickPeriod());
+    } else {
+      SensorCache::refresh();
+      executeManeuver();
     }
   }
 }
 
-double ParallelDrive::maneuverProgress(angleType format) {
+real_t ParallelDrive::maneuverProgress(angleType format) {
   if (isDriving) {
     return totalDist;
   } else if (isTurning) {
-    if (usingGyro)
+    if (usingGyro) {
       return fabs(gyroVal(format));
-    else
-      return convertAngle(encoderVal()*PI*width/180.0/wheelDiameter, DEGREES, format);
+    } else {
+      int leftCount = leftManeuverCount;  //copies, so that counts at start of turn are kept
+      int rightCount = rightManeuverCount;
+      real_t dist = combineSides(leftDrive.encoderDelta(leftCount), rightDrive.encoderDelta(rightCount));
+
+      return convertAngle(dist*PI*width/180.0/wheelDiameter, DEGREES, format);
+    }
   }
 
   return 0;
@@ -402,14 +490,317 @@ double ParallelDrive::maneuverProgress(angleType format) {
 
 bool ParallelDrive::maneuverFinished() {
   return (quadRamping && maneuverProgress() >= fabs(target))
-          || (!quadRamping && maneuverTimer->time() >= timeout);
+          || (!quadRamping && maneuverTimer.time() >= timeout);
 }
 
 bool ParallelDrive::maneuverExecuting() {
-  return isDriving || isTurning;
+  return isDriving || isTurning || isFollowing;
+}
+
+void ParallelDrive::turnToHeading(bam heading, bool runAsManeuver) {
+  bam current = (hasGyro() ? absHeading() : orientation);
+  real_t angle = -fromBam(heading - current, tDefs.defAngleType); //turn() is clockwise for positive angles
+
+  if (reverseTurns) angle *= -1; //cancels the reversal in turn(), since the heading is absolute
+  turn(angle, runAsManeuver);
+}
+
+  //#subregion path following
+void ParallelDrive::followPath(const Waypoint path[], unsigned char numPoints, bool runAsManeuver, real_t lookahead, char maxPower, real_t endTolerance, char minPower, unsigned short waitAtEnd) {
+  if (numPoints == 0) return;
+
+  this->path = path;
+  this->numPoints = numPoints;
+  trajectory = NULL;
+  this->lookahead = lookahead;
+  this->maxPower = maxPower;
+  this->endTolerance = endTolerance;
+  this->minPower = minPower;
+  pathSegment = 0;
+  pathT = 0;
+  finalDelay = waitAtEnd;
+  brakeDelay = 0;
+  quadRamping = false;  //power is already at minPower near the end, so don't brake
+  maneuverPhase = RAMPING;
+  isFollowing = true;  //see turn()
+
+  if (!runAsManeuver) waitForManeuver();
+}
+
+void ParallelDrive::followPathUpdate() {
+  updatePosition(); //rate limited, so calling it here as well as in the background is harmless
+
+  const Waypoint &end = path[numPoints-1];
+  real_t sinOrientation = bamSin(orientation), cosOrientation = bamCos(orientation);
+  real_t endDist = controlHypot(end.x - xPos, end.y - yPos);
+  real_t endAhead = (end.x - xPos)*cosOrientation + (end.y - yPos)*sinOrientation; //distance of last waypoint in front of robot
+
+  if (endDist <= endTolerance || (endDist <= lookahead && endAhead < 0)) { //reached or passed end of path
+    beginEndPhase(0, 0);
+    return;
+  }
+
+  //find furthest intersection of lookahead circle with path, no further back than the last one
+  for (unsigned char i=pathSegment; i+1 < numPoints; i++) {
+    real_t dx = path[i+1].x - path[i].x, dy = path[i+1].y - path[i].y;
+    real_t fx = path[i].x - xPos, fy = path[i].y - yPos;
+    real_t a = dx*dx + dy*dy;
+    real_t b = 2 * (fx*dx + fy*dy);
+    real_t c = fx*fx + fy*fy - lookahead*lookahead;
+    real_t discriminant = b*b - 4*a*c;
+
+    if (a == 0 || discriminant < 0) continue;
+
+    real_t t = (-b + controlSqrt(discriminant)) / (2*a); //later of the two intersections
+
+    if (0 <= t && t <= 1 && (i > pathSegment || t > pathT)) {
+      pathSegment = i;
+      pathT = t;
+    }
+  }
+
+  real_t targetX, targetY;
+
+  if (endDist <= lookahead) {
+    targetX = end.x;
+    targetY = end.y;
+  } else if (pathSegment+1 < numPoints) {
+    targetX = path[pathSegment].x + pathT*(path[pathSegment+1].x - path[pathSegment].x);
+    targetY = path[pathSegment].y + pathT*(path[pathSegment+1].y - path[pathSegment].y);
+  } else {
+    targetX = end.x;
+    targetY = end.y;
+  }
+
+  //curvature of arc through target point, tangent to robot's heading
+  real_t dx = targetX - xPos, dy = targetY - yPos;
+  real_t lateral = -dx*sinOrientation + dy*cosOrientation;  //positive to the left
+  real_t distSquared = dx*dx + dy*dy;
+  real_t curvature = (distSquared > 0 ? 2*lateral/distSquared : 0);
+
+  real_t power = maxPower;
+  if (endDist < lookahead) power = minPower + (maxPower-minPower) * endDist/lookahead;
+
+  real_t leftPower = power * (1 - curvature*width/2);
+  real_t rightPower = power * (1 + curvature*width/2);
+  real_t maxSide = fmax(fabs(leftPower), fabs(rightPower));
+
+  if (maxSide > power) {
+    leftPower *= power / maxSide;
+    rightPower *= power / maxSide;
+  }
+
+  setDrivePower(leftPower, rightPower);
+}
+
+void ParallelDrive::followTrajectory(const Trajectory &trajectory, bool runAsManeuver, bool indexByTime, real_t kV, real_t kX, real_t kY, real_t kTheta, real_t endTolerance, unsigned short waitAtEnd) {
+  if (trajectory.numSamples == 0) return;
+
+  this->trajectory = &trajectory;
+  this->indexByTime = indexByTime;
+  this->kV = kV;
+  this->kX = kX;
+  this->kY = kY;
+  this->kTheta = kTheta;
+  this->endTolerance = endTolerance;
+  trajectoryIndex = 0;
+  trajectoryDist = 0;
+  leftManeuverCount = leftDrive.encoderCount();
+  rightManeuverCount = rightDrive.encoderCount();
+  maneuverTimer.reset(); //tracks time since start of trajectory
+  finalDelay = waitAtEnd;
+  brakeDelay = 0;
+  quadRamping = false;  //velocity is already 0 at end of trajectory, so don't brake
+  maneuverPhase = RAMPING;
+  isFollowing = true;  //see turn()
+
+  if (!runAsManeuver) waitForManeuver();
+}
+
+void ParallelDrive::followTrajectoryUpdate() {
+  updatePosition();
+
+  const TrajectorySample *samples = trajectory->samples;
+  unsigned short last = trajectory->numSamples - 1;
+  real_t elapsed = maneuverTimer.timeMicros() / 1000000.0;
+
+  //choose target sample
+  if (indexByTime) {
+    while (trajectoryIndex < last && samples[trajectoryIndex+1].time <= elapsed)
+      trajectoryIndex++;
+  } else {
+    trajectoryDist += (leftDrive.encoderDelta(leftManeuverCount) + rightDrive.encoderDelta(rightManeuverCount)) / 2;
+    trajectoryIndex = fmin(last, fmax(0, trajectoryDist / trajectory->spacing) + 1);  //one sample ahead, so robot starts moving
+  }
+
+  const TrajectorySample &sample = samples[trajectoryIndex];
+
+  //error in robot's frame
+  real_t dx = sample.x - xPos, dy = sample.y - yPos;
+  real_t sinOrientation = bamSin(orientation), cosOrientation = bamCos(orientation);
+  real_t alongError = dx*cosOrientation + dy*sinOrientation;
+  real_t crossError = -dx*sinOrientation + dy*cosOrientation;
+  bam headingError = toBam(sample.heading, RADIANS) - orientation;
+
+  if (trajectoryIndex == last && (alongError <= endTolerance || elapsed > samples[last].time + 1)) {
+    beginEndPhase(0, 0);
+    return;
+  }
+
+  real_t velocity = sample.velocity*bamCos(headingError) + kX*alongError;
+  real_t angularVelocity = sample.velocity*sample.curvature + kY*sample.velocity*crossError + kTheta*bamSin(headingError);
+
+  real_t leftPower = kV * (velocity - angularVelocity*width/2);
+  real_t rightPower = kV * (velocity + angularVelocity*width/2);
+  real_t maxSide = fmax(fabs(leftPower), fabs(rightPower));
+
+  if (maxSide > 127) {
+    leftPower *= 127 / maxSide;
+    rightPower *= 127 / maxSide;
+  }
+
+  setDrivePower(leftPower, rightPower);
+}
+  //#endsubregion
+
+  //#subregion maneuver queue
+bool ParallelDrive::queueDrive(real_t dist, char maxPower) {
+  return queueSegment(DRIVE_SEGMENT, dist, 0, maxPower);
+}
+
+bool ParallelDrive::queueTurn(real_t angle, angleType format) {
+  return queueSegment(TURN_SEGMENT, convertAngle(angle, format, DEGREES), 0, tDefs.rampConst2);
+}
+
+bool ParallelDrive::queueArc(real_t radius, real_t angle, angleType format, char maxPower) {
+  if (fabs(radius) < width/2) return false; //possible debug location
+
+  return queueSegment(ARC_SEGMENT, convertAngle(angle, format, DEGREES), radius, maxPower);
+}
+
+bool ParallelDrive::queueSegment(segmentType type, real_t amount, real_t radius, char maxPower) {
+  if (numSegments >= MAX_SEGMENTS) return false;  //possible debug location
+
+  ManeuverSegment &segment = segments[numSegments];
+  segment.type = type;
+  segment.amount = amount;
+  segment.radius = radius;
+  segment.maxPower = maxPower;
+  numSegments++; //incremented last, so a running queue never sees a partially written segment
+
+  return true;
+}
+
+void ParallelDrive::runQueue(bool runAsManeuver) {
+  if (queueRunning || numSegments == 0) return;
+
+  queueRunning = true;
+  segmentIndex = 0;
+  startSegment(false);
+
+  if (!runAsManeuver) waitForManeuver();
+}
+
+void ParallelDrive::cancelQueue() {
+  clearQueue();
+  isDriving = false;
+  isTurning = false;
+  isFollowing = false;
+  maneuverPhase = RAMPING;
+  setDrivePower(0, 0);
+}
+
+int ParallelDrive::currentSegment() {
+  return queueRunning ? segmentIndex : -1;
+}
+
+unsigned char ParallelDrive::queuedSegments() { return numSegments; }
+
+void ParallelDrive::clearQueue() {
+  queueRunning = false;
+  numSegments = 0;
+}
+
+bool ParallelDrive::blendable(const ManeuverSegment &from, const ManeuverSegment &to) {
+  return from.type != TURN_SEGMENT && to.type != TURN_SEGMENT && sgn(from.amount) == sgn(to.amount);
+}
+
+bool ParallelDrive::nextSegment() {
+  if (!queueRunning || segmentIndex+1 >= numSegments) return false;
+
+  bool carryPower = blendable(segments[segmentIndex], segments[segmentIndex+1]);
+  segmentIndex++;
+  startSegment(carryPower);
+
+  return true;
+}
+
+void ParallelDrive::startSegment(bool carryPower) {
+  ManeuverSegment &segment = segments[segmentIndex];
+  bool blendIntoNext = segmentIndex+1 < numSegments && blendable(segment, segments[segmentIndex+1]);
+
+  isDriving = false;
+  isTurning = false;
+
+  if (segment.type == TURN_SEGMENT) {
+    turn(segment.amount, true, tDefs.rampConst1, tDefs.rampConst2, tDefs.rampConst3, 0, tDefs.rampConst5, DEGREES);
+  } else {
+    real_t dist = segment.amount;
+    real_t leftScale = 1, rightScale = 1;
+
+    if (segment.type == ARC_SEGMENT) {
+      dist = fabs(segment.radius) * convertAngle(segment.amount, DEGREES, RADIANS);
+      leftScale = (segment.radius - width/2) / segment.radius;
+      rightScale = (segment.radius + width/2) / segment.radius;
+    }
+
+    //ramp from the power the last segment ended at and, if the next segment continues in the same direction, end at (rather than below) its maximum
+    real_t initialPower = (carryPower ? fmin(abs(lastPower), segment.maxPower) : dDefs.rampConst1);
+    real_t finalPower = (blendIntoNext ? fmin(segment.maxPower, segments[segmentIndex+1].maxPower) : dDefs.rampConst3);
+    correctionType correction = (segment.type == ARC_SEGMENT ? ENCODER : dDefs.defCorrectionType);
+
+    startDrive(dist, true, initialPower, segment.maxPower, finalPower, 0, dDefs.rampConst5, dDefs.waitAtEnd, dDefs.kP_c, dDefs.kI_c, dDefs.kD_c, correction, false,
+               dDefs.minSpeed, dDefs.moveTimeout, dDefs.brakePower, dDefs.brakeDuration, dDefs.sampleTime, leftScale, rightScale);
+  }
+}
+  //#endsubregion
+
+void ParallelDrive::runInBackground(unsigned short period) {
+  if (!scheduled && Scheduler::add(backgroundJob, this, period) >= 0)
+    scheduled = true;
+}
+
+bool ParallelDrive::runningInBackground() {
+  return scheduled && Scheduler::isRunning();
+}
+
+void ParallelDrive::backgroundJob(void *drive) {
+  ParallelDrive *self = static_cast<ParallelDrive*>(drive);
+  self->updatePosition();
+  self->executeManeuver();
 }
 
 void ParallelDrive::initializeDefaults() {
+  //path following
+  pDefs.lookahead = 12;
+  pDefs.endTolerance = 1;
+  pDefs.maxPower = 100;
+  pDefs.minPower = 30;
+  pDefs.waitAtEnd = 100;
+  isFollowing = false;
+
+  //trajectory following
+  trDefs.kV = 6;
+  trDefs.kX = 2;
+  trDefs.kY = 0.02;
+  trDefs.kTheta = 3;
+  trDefs.endTolerance = 0.5;
+  trDefs.waitAtEnd = 100;
+
+  //maneuver queue
+  numSegments = 0;
+  queueRunning = false;
+
   //turning
   tDefs.defAngleType = DEGREES;
   tDefs.useGyro = true;
@@ -446,30 +837,30 @@ void ParallelDrive::initializeDefaults() {
 //#region accessors and mutators
   //#subregion sensors
 void ParallelDrive::setEncoderConfig(encoderConfig config) { encConfig = config; }
-void ParallelDrive::setAbsAngle(double angle, angleType format) {
-  angle = convertAngle(angle, format, DEGREES);
-  angleOffset = angle - gyroVal();
+void ParallelDrive::setAbsAngle(real_t angle, angleType format) {
+  angleOffset = toBam(angle, format) - degreesToBam(SensorCache::gyro(gyroPort));
 }
 bool ParallelDrive::hasGyro() { return gyro; }  //TODO: verify that this works
   //#endsubregion
   //#subregion position tracking
-void ParallelDrive::setWidth(double inches) { width = inches; }
-void ParallelDrive::setRobotPosition(double x, double y, double theta, angleType format, bool updateAngleOffset) {
+void ParallelDrive::setWidth(real_t inches) { width = inches; }
+void ParallelDrive::setRobotPosition(real_t x, real_t y, real_t theta, angleType format, bool updateAngleOffset) {
   xPos = x;
   yPos = y;
-  orientation = convertAngle(theta, format, RADIANS);
-  if (updateAngleOffset) setAbsAngle(convertAngle(theta, format, DEGREES));
+  orientation = toBam(theta, format);
+  if (updateAngleOffset) setAbsAngle(theta, format);
 }
-double ParallelDrive::x() { return xPos; }
-double ParallelDrive::y() { return yPos; }
-double ParallelDrive::theta(angleType format) { return convertAngle(orientation, RADIANS, format); }
+real_t ParallelDrive::x() { return xPos; }
+real_t ParallelDrive::y() { return yPos; }
+real_t ParallelDrive::theta(angleType format) { return fromBam(orientation, format); }
+bam ParallelDrive::heading() { return orientation; }
   //#endsubregion
   //#subregion autonomous
 void ParallelDrive::setCorrectionType(correctionType type) {
   if (type==GYRO && hasGyro()) {
 		correction = GYRO;
 		while (fabs(gyroVal()) > 1) resetGyro(); //I'm horrible, I know (this is here so gyro is only reset when correcting with it)
-	} else if (type==ENCODER && leftDrive->hasEncoder() && rightDrive->hasEncoder()) {
+	} else if (type==ENCODER && leftDrive.hasEncoder() && rightDrive.hasEncoder()) {
 		correction = ENCODER;
 	} else {
 		correction = NONE;
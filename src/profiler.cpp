@@ -0,0 +1,105 @@
+#include "profiler.h" //also includes API
+
+ProfileStats Profiler::profiles[MAX_PROFILES] = {
+  {"drive input"}, {"odometry"}, {"drive maneuver"}, {"group maneuver"},
+  {"group target"}, {"holonomic input"}, {"scheduler tick"}
+};
+unsigned long Profiler::deadlines[MAX_PROFILES];
+unsigned long Profiler::loopPeriod = 20000;
+unsigned long Profiler::lastStart[MAX_PROFILES];
+unsigned char Profiler::numProfiles = PROFILE_USER;
+
+static void clearStats(ProfileStats &stats) {
+  const char *name = stats.name;
+  stats = ProfileStats();
+  stats.name = name;
+}
+
+char Profiler::add(const char *name, unsigned long deadline) {
+  if (numProfiles >= MAX_PROFILES) return -1;  //possible debug location
+
+  clearStats(profiles[numProfiles]);
+  profiles[numProfiles].name = name;
+  deadlines[numProfiles] = deadline;
+  return numProfiles++;
+}
+
+void Profiler::record(char id, unsigned long start, unsigned long elapsed) {
+  if (id < 0 || id >= numProfiles) return;
+
+  ProfileStats &stats = profiles[(unsigned char)id];
+
+  if (stats.runs > 0) {
+    unsigned long period = start - lastStart[(unsigned char)id];
+    if (stats.runs == 1 || period < stats.minPeriod) stats.minPeriod = period;
+    if (period > stats.maxPeriod) stats.maxPeriod = period;
+  }
+
+  if (stats.runs == 0 || elapsed < stats.minTime) stats.minTime = elapsed;
+  if (elapsed > stats.maxTime) stats.maxTime = elapsed;
+  if (elapsed > getDeadline(id)) stats.overruns++;  //possible debug location
+
+  unsigned char bucket = 0;
+  for (unsigned long limit=32; elapsed>=limit && bucket<PROFILE_BUCKETS-1; limit<<=1) bucket++;
+  stats.histogram[bucket]++;
+
+  stats.totalTime += elapsed;
+  stats.runs++;
+  lastStart[(unsigned char)id] = start;
+}
+
+void Profiler::setLoopPeriod(unsigned short period) { loopPeriod = period * 1000ul; }
+
+void Profiler::setDeadline(char id, unsigned long deadline) {
+  if (0 <= id && id < MAX_PROFILES) deadlines[(unsigned char)id] = deadline;
+}
+
+unsigned long Profiler::getDeadline(char id) {
+  if (0 <= id && id < MAX_PROFILES && deadlines[(unsigned char)id] != 0)
+    return deadlines[(unsigned char)id];
+
+  return loopPeriod;
+}
+
+//#region statistics
+bool Profiler::getStats(char id, ProfileStats &stats) {
+  if (0 <= id && id < numProfiles) {
+    stats = profiles[(unsigned char)id];
+    return true;
+  }
+
+  return false;
+}
+
+void Profiler::resetStats() {
+  for (unsigned char i=0; i<numProfiles; i++)
+    clearStats(profiles[i]);
+}
+
+void Profiler::printStats() {
+  printf("profile          runs overruns  min(us)  avg(us)  max(us) min period max period  histogram (<32us, <64us, ... <2ms, >=2ms)\n");
+
+  for (unsigned char i=0; i<numProfiles; i++) {
+    const ProfileStats &s = profiles[i];
+
+    if (s.runs > 0) {
+      printf("%-15s %6lu %8lu %8lu %8lu %8lu %10lu %10lu ", s.name, s.runs, s.overruns,
+             s.minTime, s.totalTime/s.runs, s.maxTime, s.minPeriod, s.maxPeriod);
+
+      for (unsigned char bucket=0; bucket<PROFILE_BUCKETS; bucket++)
+        printf(" %lu", s.histogram[bucket]);
+
+      printf("\n");
+    }
+  }
+}
+
+void Profiler::printStats(FILE *lcdPort, char id) {
+  if (0 <= id && id < numProfiles) {
+    const ProfileStats &s = profiles[(unsigned char)id];
+
+    lcdPrint(lcdPort, 1, "%.11s %4lu", s.name, s.overruns);
+    lcdPrint(lcdPort, 2, "%5luus %6luus", (s.runs ? s.totalTime/s.runs : 0), s.maxTime);
+  }
+}
+//#endregion
@@ -1,12 +1,12 @@
 #include "quadRamp.h"
 #include "coreIncludes.h" //also includes cmath
 
-QuadRamp::QuadRamp(float target, float initial, float maximum, float end) {
+QuadRamp::QuadRamp(real_t target, real_t initial, real_t maximum, real_t end) {
   a = ((end + initial - 2*maximum) - 2*sqrt((end-maximum) * (initial-maximum))) / pow(target, 2);
 	b = ((end-initial)/target - a*target) * sgn(target);
   c = initial;
 }
 
-double QuadRamp::evaluate(double input) {
-  return a*pow(input, 2) + b*input + c;
+real_t QuadRamp::evaluate(real_t input) {
+  return (a*input + b)*input + c;
 }
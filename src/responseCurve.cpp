@@ -0,0 +1,18 @@
+#include "responseCurve.h"
+#include <cmath>
+
+ResponseCurve::ResponseCurve(double coeff, double powMap, unsigned char deadband) {
+  configure(coeff, powMap, deadband);
+}
+
+void ResponseCurve::configure(double coeff, double powMap, unsigned char deadband) {
+  for (int input=-128; input<=127; input++) {
+    double power = coeff * copysign(127 * pow(fabs(input / 127.0), powMap), input);
+
+    if (power > 127) power = 127;
+    if (power < -127) power = -127;
+    if (fabs(power) < deadband) power = 0;
+
+    table[(unsigned char)input] = power;
+  }
+}
@@ -0,0 +1,135 @@
+#include "scheduler.h" //also includes API
+#include "sensorCache.h"
+#include "profiler.h"
+
+struct Job {
+  JobFunction function;
+  void *object;
+  unsigned short period;
+  unsigned long nextRun;  //millis() at which job is next due
+  JobStats stats;
+  bool used;
+};
+
+static Job jobs[MAX_JOBS];
+
+TaskHandle Scheduler::task;
+unsigned short Scheduler::tickPeriod = 5;
+
+static void clearStats(JobStats &stats) {
+  stats.runs = 0;
+  stats.missed = 0;
+  stats.minTime = (unsigned long)-1;
+  stats.maxTime = 0;
+  stats.totalTime = 0;
+  stats.maxJitter = 0;
+  stats.totalJitter = 0;
+}
+
+void Scheduler::run(void *ignore) {
+  unsigned long wakeTime = millis();
+
+  while (true) {
+    {
+      PROFILE_SCOPE(PROFILE_SCHEDULER_TICK);
+      SensorCache::refresh();
+
+      for (unsigned char i=0; i<MAX_JOBS; i++) {
+        Job &job = jobs[i];
+        unsigned long now = millis();
+
+        if (job.used && (long)(now - job.nextRun) >= 0) {
+          if ((long)(now - job.nextRun) >= job.period) {  //fell a full period behind, so skip missed runs
+            job.stats.missed++;
+            job.nextRun = now;
+          }
+
+          unsigned long start = micros();
+          job.function(job.object);
+          unsigned long elapsed = micros() - start;
+          long late = (long)(now - job.nextRun);  //both in milliseconds from millis()
+          unsigned long jitter = (late > 0 ? late : 0);
+
+          job.nextRun += job.period;
+          job.stats.runs++;
+          job.stats.totalTime += elapsed;
+          if (elapsed < job.stats.minTime) job.stats.minTime = elapsed;
+          if (elapsed > job.stats.maxTime) job.stats.maxTime = elapsed;
+          job.stats.totalJitter += jitter;
+          if (jitter > job.stats.maxJitter) job.stats.maxJitter = jitter;
+        }
+      }
+    }
+
+    taskDelayUntil(&wakeTime, tickPeriod);
+  }
+}
+
+char Scheduler::add(JobFunction function, void *object, unsigned short period) {
+  for (unsigned char i=0; i<MAX_JOBS; i++) {
+    if (!jobs[i].used) {
+      jobs[i].function = function;
+      jobs[i].object = object;
+      jobs[i].period = (period==0 ? 1 : period);
+      jobs[i].nextRun = millis();
+      clearStats(jobs[i].stats);
+      jobs[i].used = true;
+      return i;
+    }
+  }
+
+  return -1;  //possible debug location
+}
+
+void Scheduler::remove(char id) {
+  if (0 <= id && id < MAX_JOBS) jobs[(unsigned char)id].used = false;
+}
+
+bool Scheduler::start(unsigned short tickPeriod, unsigned int priority) {
+  if (task) return true;
+
+  Scheduler::tickPeriod = (tickPeriod==0 ? 1 : tickPeriod);
+  Profiler::setDeadline(PROFILE_SCHEDULER_TICK, Scheduler::tickPeriod * 1000ul);
+  SensorCache::enableLocking();  //update() may now be called while the task samples
+  task = taskCreate(run, TASK_DEFAULT_STACK_SIZE, NULL, priority);
+  return task;
+}
+
+void Scheduler::stop() {
+  if (task) {
+    taskDelete(task);
+    task = NULL;
+  }
+}
+
+bool Scheduler::isRunning() { return task; }
+unsigned short Scheduler::getTickPeriod() { return tickPeriod; }
+
+//#region statistics
+bool Scheduler::getStats(char id, JobStats &stats) {
+  if (0 <= id && id < MAX_JOBS && jobs[(unsigned char)id].used) {
+    stats = jobs[(unsigned char)id].stats;
+    return true;
+  }
+
+  return false;
+}
+
+void Scheduler::resetStats() {
+  for (unsigned char i=0; i<MAX_JOBS; i++)
+    clearStats(jobs[i].stats);
+}
+
+void Scheduler::printStats() {
+  printf("job period   runs missed  min(us)  avg(us)  max(us) jitter(ms) max jitter\n");
+
+  for (unsigned char i=0; i<MAX_JOBS; i++) {
+    const JobStats &s = jobs[i].stats;
+
+    if (jobs[i].used && s.runs > 0) {
+      printf("%3d %6u %6lu %6lu %8lu %8lu %8lu %10lu %10lu\n", i, jobs[i].period, s.runs, s.missed,
+             s.minTime, s.totalTime/s.runs, s.maxTime, s.totalJitter/s.runs, s.maxJitter);
+    }
+  }
+}
+//#endregion
@@ -0,0 +1,144 @@
+#include "sensorCache.h"  //also includes API
+#include "buttonTracker.h"
+#include "inputRecorder.h"
+#include "timer.h"
+
+SensorSnapshot SensorCache::values;
+bool SensorCache::active;
+Mutex SensorCache::writeLock;
+Encoder SensorCache::encoderHandles[CACHE_NUM_ENCODER_PORTS];
+Gyro SensorCache::gyroHandles[BOARD_NR_ADC_PINS];
+unsigned short SensorCache::encoderMask;
+unsigned char SensorCache::gyroMask;
+unsigned char SensorCache::analogMask;
+unsigned char SensorCache::axisMask[CACHE_NUM_JOYSTICKS];
+
+void SensorCache::update() {
+  lock();
+  sample();
+
+  if (InputRecorder::isPlaying()) {
+    unsigned long buttons;
+    InputRecorder::play(values, buttons);
+    ButtonTracker::update(buttons);
+  } else {
+    ButtonTracker::update();
+    InputRecorder::record(values, ButtonTracker::pressedMask());
+  }
+
+  unlock();
+}
+
+void SensorCache::refresh() {
+  if (active) {
+    lock();
+    sample();
+    unlock();
+  }
+}
+
+void SensorCache::enableLocking() {
+  if (!writeLock) writeLock = mutexCreate();
+}
+
+void SensorCache::lock() {
+  if (writeLock) mutexTake(writeLock, -1);
+}
+
+void SensorCache::unlock() {
+  if (writeLock) mutexGive(writeLock);
+}
+
+void SensorCache::sample() {
+  active = true;
+  values.time = millis();
+  TickTimer::tick();
+
+  for (unsigned char i=0; i<CACHE_NUM_ENCODER_PORTS; i++)
+    if (encoderMask & (1 << i)) values.encoders[i] = encoderGet(encoderHandles[i]);
+
+  for (unsigned char i=0; i<BOARD_NR_ADC_PINS; i++) {
+    if (gyroMask & (1 << i))
+      values.analog[i] = gyroGet(gyroHandles[i]);
+    else if (analogMask & (1 << i))
+      values.analog[i] = analogRead(i+1);
+  }
+
+  if (!InputRecorder::isPlaying()) {  //otherwise axes are set by InputRecorder::play()
+    for (unsigned char j=0; j<CACHE_NUM_JOYSTICKS; j++)
+      for (unsigned char i=0; i<6; i++)
+        if (axisMask[j] & (1 << i)) values.axes[j][i] = joystickGetAnalog(j+1, i+1);
+  }
+}
+
+bool SensorCache::isActive() { return active; }
+const SensorSnapshot& SensorCache::snapshot() { return values; }
+
+//#region registration
+void SensorCache::addEncoder(unsigned char topPort, Encoder encoder) {
+  if (1 <= topPort && topPort <= CACHE_NUM_ENCODER_PORTS) {
+    encoderHandles[topPort-1] = encoder;
+    encoderMask |= 1 << (topPort-1);
+    if (active) values.encoders[topPort-1] = encoderGet(encoder);
+  }
+}
+
+void SensorCache::addGyro(unsigned char port, Gyro gyro) {
+  if (1 <= port && port <= BOARD_NR_ADC_PINS) {
+    gyroHandles[port-1] = gyro;
+    gyroMask |= 1 << (port-1);
+    if (active) values.analog[port-1] = gyroGet(gyro);
+  }
+}
+
+void SensorCache::resetGyro(unsigned char port) {
+  if (1 <= port && port <= BOARD_NR_ADC_PINS && (gyroMask & (1 << (port-1)))) {
+    gyroReset(gyroHandles[port-1]);
+    values.analog[port-1] = 0;
+  }
+}
+
+void SensorCache::addAnalog(unsigned char port) {
+  if (1 <= port && port <= BOARD_NR_ADC_PINS) {
+    analogMask |= 1 << (port-1);
+    if (active) values.analog[port-1] = analogRead(port);
+  }
+}
+
+void SensorCache::addJoystickAxis(unsigned char axis, unsigned char joystick) {
+  if (1 <= joystick && joystick <= CACHE_NUM_JOYSTICKS && 1 <= axis && axis <= 6) {
+    axisMask[joystick-1] |= 1 << (axis-1);
+    if (active) values.axes[joystick-1][axis-1] = joystickGetAnalog(joystick, axis);
+  }
+}
+//#endregion
+
+//#region values
+int SensorCache::encoder(unsigned char topPort) {
+  if (1 <= topPort && topPort <= CACHE_NUM_ENCODER_PORTS && (encoderMask & (1 << (topPort-1))))
+    return active ? values.encoders[topPort-1] : encoderGet(encoderHandles[topPort-1]);
+
+  return 0; //possible debug location
+}
+
+int SensorCache::gyro(unsigned char port) {
+  if (1 <= port && port <= BOARD_NR_ADC_PINS && (gyroMask & (1 << (port-1))))
+    return active ? values.analog[port-1] : gyroGet(gyroHandles[port-1]);
+
+  return 0; //possible debug location
+}
+
+int SensorCache::analog(unsigned char port) {
+  if (active && 1 <= port && port <= BOARD_NR_ADC_PINS && (analogMask & (1 << (port-1))))
+    return values.analog[port-1];
+
+  return analogRead(port);
+}
+
+int SensorCache::joystickAnalog(unsigned char axis, unsigned char joystick) {
+  if (active && 1 <= joystick && joystick <= CACHE_NUM_JOYSTICKS && 1 <= axis && axis <= 6 && (axisMask[joystick-1] & (1 << (axis-1))))
+    return values.axes[joystick-1][axis-1];
+
+  return joystickGetAnalog(joystick, axis);
+}
+//#endregion
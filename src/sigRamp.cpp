@@ -1,11 +1,11 @@
 #include "sigRamp.h"
 #include <cmath>
 
-SigRamp::SigRamp(double k, double M, double intercept) : k(k), M2(2*M), i(intercept) {
+SigRamp::SigRamp(real_t k, real_t M, real_t intercept) : k(k), M2(2*M), i(intercept) {
   C = 2 * M / i - 1;
   s = log((M2/(M+i) - 1) / C) / (k * M2);
 }
 
-double SigRamp::evaluate(double input) {
+real_t SigRamp::evaluate(real_t input) {
   return M2 / (1 + C * exp(-k * M2 * (input + s)));
 }
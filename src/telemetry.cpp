@@ -0,0 +1,133 @@
+#include "telemetry.h" //also includes API
+
+static_assert((TELEMETRY_BUFFER_SIZE & (TELEMETRY_BUFFER_SIZE-1)) == 0, "TELEMETRY_BUFFER_SIZE must be a power of 2");
+
+TelemetryRecord Telemetry::buffer[TELEMETRY_BUFFER_SIZE];
+unsigned int Telemetry::head;
+unsigned int Telemetry::tail;
+unsigned long Telemetry::droppedCount;
+FILE* Telemetry::port;
+TaskHandle Telemetry::task;
+
+bool Telemetry::start(FILE *port, unsigned int priority) {
+  if (TELEMETRY_LEVEL == 0) return false;
+  if (task) return true;
+
+  Telemetry::port = port;
+  task = taskCreate(run, TASK_DEFAULT_STACK_SIZE, NULL, priority);
+  return task;
+}
+
+void Telemetry::stop() {
+  if (task) {
+    taskDelete(task);
+    task = NULL;
+  }
+}
+
+bool Telemetry::isRunning() { return task; }
+unsigned int Telemetry::pending() { return __atomic_load_n(&head, __ATOMIC_ACQUIRE) - tail; }
+unsigned long Telemetry::dropped() { return droppedCount; }
+
+void Telemetry::run(void *ignore) {
+  while (true) {
+    flush();
+    delay(10);
+  }
+}
+
+//#region logging
+TelemetryRecord* Telemetry::claim(unsigned char type, unsigned char source) {
+  unsigned int index = __atomic_load_n(&head, __ATOMIC_RELAXED);
+
+  do {
+    if (index - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= TELEMETRY_BUFFER_SIZE) {
+      droppedCount++; //possible debug location
+      return NULL;
+    }
+  } while (!__atomic_compare_exchange_n(&head, &index, index+1, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+  TelemetryRecord *record = &buffer[index % TELEMETRY_BUFFER_SIZE];
+  record->time = micros();
+  record->type = type;
+  record->source = source;
+  return record;
+}
+
+void Telemetry::log(unsigned char type, unsigned char source, float a, float b, float c) {
+  TelemetryRecord *record = claim(type & ~TELEMETRY_INTEGER, source);
+
+  if (record) {
+    record->values.real[0] = a;
+    record->values.real[1] = b;
+    record->values.real[2] = c;
+    __atomic_store_n(&record->ready, true, __ATOMIC_RELEASE);
+  }
+}
+
+void Telemetry::logCounts(unsigned char type, unsigned char source, long a, long b, long c) {
+  TelemetryRecord *record = claim(type | TELEMETRY_INTEGER, source);
+
+  if (record) {
+    record->values.integer[0] = a;
+    record->values.integer[1] = b;
+    record->values.integer[2] = c;
+    __atomic_store_n(&record->ready, true, __ATOMIC_RELEASE);
+  }
+}
+//#endregion
+
+//#region sending
+static unsigned char* putLong(unsigned char *out, unsigned long value) {
+  for (unsigned char i=0; i<4; i++)
+    *out++ = value >> (8*i);
+
+  return out;
+}
+
+void Telemetry::send(const TelemetryRecord &record) {
+  unsigned char frame[TELEMETRY_FRAME_SIZE];
+  unsigned char *out = frame;
+
+  *out++ = 0xA5;
+  *out++ = 0x5A;
+  *out++ = record.type;
+  *out++ = record.source;
+  out = putLong(out, record.time);
+
+  for (unsigned char i=0; i<3; i++) {
+    union { float real; unsigned int bits; } value;
+
+    if (record.type & TELEMETRY_INTEGER) {
+      out = putLong(out, record.values.integer[i]);
+    } else {
+      value.real = record.values.real[i];
+      out = putLong(out, value.bits);
+    }
+  }
+
+  unsigned char checksum = 0;
+  for (unsigned char *byte=frame+2; byte<out; byte++) checksum += *byte;
+  *out = checksum;
+
+#ifdef SIMULATION
+  for (unsigned char i=0; i<TELEMETRY_FRAME_SIZE; i++)
+    putchar(frame[i]);  //the simulator only models stdout, which is the host's
+#else
+  fwrite(frame, 1, TELEMETRY_FRAME_SIZE, port ? port : stdout);
+#endif
+}
+
+void Telemetry::flush() {
+  while (tail != __atomic_load_n(&head, __ATOMIC_ACQUIRE)) {
+    TelemetryRecord &record = buffer[tail % TELEMETRY_BUFFER_SIZE];
+
+    if (!__atomic_load_n(&record.ready, __ATOMIC_ACQUIRE)) break; //claimed, but still being written
+
+    TelemetryRecord copy = record;
+    record.ready = false;
+    __atomic_store_n(&tail, tail+1, __ATOMIC_RELEASE);  //frees slot before the (slow) serial write
+    send(copy);
+  }
+}
+//#endregion
@@ -12,3 +12,22 @@ unsigned long Timer::time() {
 Timer::Timer() {
 	lastReset = millis();
 }
+
+//#region TickTimer
+unsigned long TickTimer::tickTime;
+bool TickTimer::ticking;
+
+void TickTimer::tick() {
+  tickTime = micros();
+  ticking = true;
+}
+
+unsigned long TickTimer::now() {
+  return (ticking ? tickTime : micros());
+}
+
+void TickTimer::reset() { lastReset = now(); }
+unsigned long TickTimer::time() { return (now() - lastReset) / 1000; }
+unsigned long TickTimer::timeMicros() { return now() - lastReset; }
+TickTimer::TickTimer() : lastReset(now()) {}
+//#endregion
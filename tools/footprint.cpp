@@ -0,0 +1,43 @@
+/* Host-side report of the size of library objects (built by `make footprint`)
+
+  Built twice, with real_t as float (the default) and as double
+  (-DDOUBLE_PRECISION), so the RAM cost of each precision can be compared.
+  Pointers are 8 bytes on the host and 4 on the Cortex, so absolute sizes are
+  somewhat larger than on the robot; the difference between the two builds is
+  what real_t contributes. Cycle counts of either configuration need the
+  Cortex itself.
+
+  Usage: footprint */
+
+#include "parallelDrive.h"
+#include "holonomicDrive.h"
+#include "buttonGroup.h"
+#include "PID.h"
+#include "fixedPID.h"
+#include "quadRamp.h"
+#include "sigRamp.h"
+#include "sensorCache.h"
+
+#define PRINT_SIZE(type) printf("  %-16s %6u\n", #type, (unsigned int)sizeof(type))
+
+int main() {
+#ifdef DOUBLE_PRECISION
+  printf("real_t = double (-DDOUBLE_PRECISION), bytes:\n");
+#else
+  printf("real_t = float (default), bytes:\n");
+#endif
+
+  PRINT_SIZE(real_t);
+  PRINT_SIZE(ParallelDrive);
+  PRINT_SIZE(HolonomicDrive);
+  PRINT_SIZE(MotorGroup);
+  PRINT_SIZE(JoystickGroup);
+  PRINT_SIZE(ButtonGroup);
+  PRINT_SIZE(PID);
+  PRINT_SIZE(FixedPID);
+  PRINT_SIZE(QuadRamp);
+  PRINT_SIZE(SigRamp);
+  PRINT_SIZE(ManeuverSegment);
+  PRINT_SIZE(SensorSnapshot);
+  return 0;
+}
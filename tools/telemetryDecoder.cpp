@@ -0,0 +1,102 @@
+/* Host-side decoder of Telemetry frames (built by `make decoder`)
+
+  Reads a capture of the robot's serial output, skips any text printed
+  between frames, and writes one CSV row per valid frame. Frames with a bad
+  checksum are counted and skipped, and decoding resynchronizes on the next
+  sync bytes. See include/telemetry.h for the frame format.
+
+  Usage: telemetryDecoder [capture file] [output.csv]
+    (reads stdin and writes stdout when files are omitted) */
+
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+
+static const int FRAME_SIZE = 21;
+static const unsigned char SYNC1 = 0xA5, SYNC2 = 0x5A, INTEGER = 0x80;
+
+static const char *typeName(unsigned char type) {
+  switch (type & ~INTEGER) {
+    case 1: return "pose";
+    case 2: return "odometry";
+    case 3: return "controller";
+    case 4: return "motors";
+    case 5: return "event";
+    default: return "user";
+  }
+}
+
+static uint32_t getLong(const unsigned char *bytes) {
+  return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static void writeRow(FILE *out, const unsigned char *frame) {
+  unsigned char type = frame[2];
+
+  fprintf(out, "%u,%s,%u,%u", getLong(frame+4), typeName(type), type & ~INTEGER, frame[3]);
+
+  for (int i=0; i<3; i++) {
+    uint32_t bits = getLong(frame + 8 + 4*i);
+
+    if (type & INTEGER) {
+      fprintf(out, ",%d", (int32_t)bits);
+    } else {
+      float value;
+      memcpy(&value, &bits, sizeof(value));
+      fprintf(out, ",%g", value);
+    }
+  }
+
+  fprintf(out, "\n");
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 3) {
+    printf("Usage: %s [capture file] [output.csv]\n", argv[0]);
+    return 1;
+  }
+
+  FILE *in = (argc > 1 ? fopen(argv[1], "rb") : stdin);
+  FILE *out = (argc > 2 ? fopen(argv[2], "w") : stdout);
+
+  if (!in || !out) {
+    fprintf(stderr, "Could not open %s\n", (in ? argv[2] : argv[1]));
+    return 1;
+  }
+
+  unsigned char frame[FRAME_SIZE];
+  int length = 0, c;
+  unsigned long frames = 0, corrupt = 0;
+
+  fprintf(out, "time_us,type,type_id,source,a,b,c\n");
+
+  while ((c = fgetc(in)) != EOF) {
+    if (length == 0 && c != SYNC1) continue;  //text between frames
+    if (length == 1 && c != SYNC2) {
+      length = (c == SYNC1 ? 1 : 0);
+      continue;
+    }
+
+    frame[length++] = c;
+
+    if (length == FRAME_SIZE) {
+      unsigned char checksum = 0;
+      for (int i=2; i<FRAME_SIZE-1; i++) checksum += frame[i];
+
+      if (checksum == frame[FRAME_SIZE-1]) {
+        writeRow(out, frame);
+        frames++;
+        length = 0;
+      } else {  //resynchronize on the next sync bytes after this frame's start
+        corrupt++;
+        int start = 1;
+        while (start < FRAME_SIZE && !(frame[start] == SYNC1 && (start+1 == FRAME_SIZE || frame[start+1] == SYNC2))) start++;
+        length = FRAME_SIZE - start;
+        memmove(frame, frame+start, length);
+      }
+    }
+  }
+
+  fprintf(stderr, "%lu frames decoded, %lu corrupt frames skipped\n", frames, corrupt);
+  return 0;
+}
@@ -0,0 +1,244 @@
+/* Host-side generator of trajectory tables (built and run by `make trajectories`)
+
+  Reads a path file describing waypoints and constraints, fits a cubic Hermite
+  spline through the waypoints, samples it at even distances and computes a
+  velocity profile limited by maximum velocity, maximum acceleration and (on
+  curves) the speed of the outer side of the drive. Writes a header defining a
+  constexpr Trajectory for ParallelDrive::followTrajectory().
+
+  Path file format (one entry per line, # starts a comment):
+    name <identifier>         name of generated Trajectory (default: file name)
+    maxVelocity <in/s>
+    maxAcceleration <in/s^2>
+    width <inches>            width of drive (wheel well to wheel well)
+    spacing <inches>          distance between samples (default 1)
+    waypoint <x> <y> <heading in degrees>
+
+  Usage: trajectoryGenerator <input.path> <output.h> */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Waypoint {
+  double x, y, heading;  //inches, inches, radians
+};
+
+struct Sample {
+  double x, y, heading, velocity, curvature, time;
+};
+
+struct PathConfig {
+  std::string name;
+  double maxVelocity, maxAcceleration, width, spacing;
+  std::vector<Waypoint> waypoints;
+};
+
+static const double PI = acos(-1);
+
+//#region parsing
+static bool readPath(const char *filename, PathConfig &config) {
+  FILE *file = fopen(filename, "r");
+
+  if (!file) {
+    fprintf(stderr, "Could not open %s\n", filename);
+    return false;
+  }
+
+  char line[256];
+  int lineNumber = 0;
+
+  while (fgets(line, sizeof(line), file)) {
+    lineNumber++;
+    char *comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    char key[64], text[64];
+    double a, b, c;
+
+    if (sscanf(line, "%63s", key) != 1) continue; //blank line
+
+    if (strcmp(key, "name") == 0 && sscanf(line, "%*s %63s", text) == 1) {
+      config.name = text;
+    } else if (strcmp(key, "maxVelocity") == 0 && sscanf(line, "%*s %lf", &a) == 1) {
+      config.maxVelocity = a;
+    } else if (strcmp(key, "maxAcceleration") == 0 && sscanf(line, "%*s %lf", &a) == 1) {
+      config.maxAcceleration = a;
+    } else if (strcmp(key, "width") == 0 && sscanf(line, "%*s %lf", &a) == 1) {
+      config.width = a;
+    } else if (strcmp(key, "spacing") == 0 && sscanf(line, "%*s %lf", &a) == 1) {
+      config.spacing = a;
+    } else if (strcmp(key, "waypoint") == 0 && sscanf(line, "%*s %lf %lf %lf", &a, &b, &c) == 3) {
+      config.waypoints.push_back({a, b, c * PI / 180});
+    } else {
+      fprintf(stderr, "%s:%d: could not parse line\n", filename, lineNumber);
+      fclose(file);
+      return false;
+    }
+  }
+
+  fclose(file);
+
+  if (config.waypoints.size() < 2 || config.maxVelocity <= 0 || config.maxAcceleration <= 0 || config.spacing <= 0) {
+    fprintf(stderr, "%s: need at least 2 waypoints and positive maxVelocity, maxAcceleration and spacing\n", filename);
+    return false;
+  }
+
+  return true;
+}
+//#endregion
+
+//#region spline
+struct Segment {  //cubic Hermite segment between two waypoints
+  double ax, bx, cx, dx, ay, by, cy, dy;
+
+  Segment(const Waypoint &start, const Waypoint &end) {
+    double scale = 1.2 * hypot(end.x - start.x, end.y - start.y); //tangent magnitude
+    double tx0 = scale * cos(start.heading), ty0 = scale * sin(start.heading);
+    double tx1 = scale * cos(end.heading), ty1 = scale * sin(end.heading);
+
+    ax = 2*start.x - 2*end.x + tx0 + tx1;
+    bx = -3*start.x + 3*end.x - 2*tx0 - tx1;
+    cx = tx0;
+    dx = start.x;
+    ay = 2*start.y - 2*end.y + ty0 + ty1;
+    by = -3*start.y + 3*end.y - 2*ty0 - ty1;
+    cy = ty0;
+    dy = start.y;
+  }
+
+  void evaluate(double u, Sample &sample) const {
+    double x1 = (3*ax*u + 2*bx)*u + cx, y1 = (3*ay*u + 2*by)*u + cy;  //first derivatives
+    double x2 = 6*ax*u + 2*bx, y2 = 6*ay*u + 2*by;                    //second derivatives
+
+    sample.x = ((ax*u + bx)*u + cx)*u + dx;
+    sample.y = ((ay*u + by)*u + cy)*u + dy;
+    sample.heading = atan2(y1, x1);
+    sample.curvature = (x1*y2 - y1*x2) / pow(x1*x1 + y1*y1, 1.5);
+  }
+};
+
+static std::vector<Sample> sampleSpline(const PathConfig &config) {
+  const int steps = 2000;  //integration steps per segment
+  std::vector<Sample> samples;
+  double length = 0, nextSample = 0;
+  Sample previous = {}, current = {};
+
+  for (size_t i=0; i+1 < config.waypoints.size(); i++) {
+    Segment segment(config.waypoints[i], config.waypoints[i+1]);
+    segment.evaluate(0, previous);
+
+    for (int step=1; step <= steps; step++) {
+      segment.evaluate((double)step / steps, current);
+      double stepLength = hypot(current.x - previous.x, current.y - previous.y);
+
+      while (nextSample <= length + stepLength) { //interpolate samples within this step
+        double fraction = (stepLength > 0 ? (nextSample - length) / stepLength : 0);
+        Sample sample = previous;
+        sample.x += fraction * (current.x - previous.x);
+        sample.y += fraction * (current.y - previous.y);
+        samples.push_back(sample);
+        nextSample += config.spacing;
+      }
+
+      length += stepLength;
+      previous = current;
+    }
+  }
+
+  if (nextSample - config.spacing < length - 1e-6) samples.push_back(current); //end exactly on last waypoint
+  return samples;
+}
+//#endregion
+
+//#region velocity profile
+static void profileVelocity(const PathConfig &config, std::vector<Sample> &samples) {
+  size_t n = samples.size();
+
+  for (size_t i=0; i<n; i++)  //limit speed of outer side on curves
+    samples[i].velocity = config.maxVelocity / (1 + fabs(samples[i].curvature) * config.width / 2);
+
+  samples[0].velocity = 0;
+  samples[n-1].velocity = 0;
+
+  for (size_t i=1; i<n; i++) {  //acceleration limit
+    double ds = hypot(samples[i].x - samples[i-1].x, samples[i].y - samples[i-1].y);
+    samples[i].velocity = fmin(samples[i].velocity, sqrt(pow(samples[i-1].velocity, 2) + 2*config.maxAcceleration*ds));
+  }
+
+  for (size_t i=n-1; i>0; i--) {  //deceleration limit
+    double ds = hypot(samples[i].x - samples[i-1].x, samples[i].y - samples[i-1].y);
+    samples[i-1].velocity = fmin(samples[i-1].velocity, sqrt(pow(samples[i].velocity, 2) + 2*config.maxAcceleration*ds));
+  }
+
+  samples[0].time = 0;
+
+  for (size_t i=1; i<n; i++) {
+    double ds = hypot(samples[i].x - samples[i-1].x, samples[i].y - samples[i-1].y);
+    double meanVelocity = (samples[i].velocity + samples[i-1].velocity) / 2;
+    samples[i].time = samples[i-1].time + (meanVelocity > 0 ? ds / meanVelocity : 0);
+  }
+}
+//#endregion
+
+//#region output
+static bool writeHeader(const char *filename, const PathConfig &config, const std::vector<Sample> &samples) {
+  FILE *file = fopen(filename, "w");
+
+  if (!file) {
+    fprintf(stderr, "Could not open %s for writing\n", filename);
+    return false;
+  }
+
+  std::string guard = config.name;
+  for (size_t i=0; i<guard.size(); i++) guard[i] = toupper(guard[i]);
+
+  fprintf(file, "/* Generated by tools/trajectoryGenerator.cpp - edit the path file and run\n"
+                "  `make trajectories` instead of modifying this file\n\n"
+                "  %lu samples, %.1f inches, %.2f seconds */\n\n",
+          (unsigned long)samples.size(), (samples.size()-1) * config.spacing, samples.back().time);
+  fprintf(file, "#ifndef %s_TRAJECTORY_INCLUDED\n#define %s_TRAJECTORY_INCLUDED\n\n", guard.c_str(), guard.c_str());
+  fprintf(file, "#include \"trajectory.h\"\n\n");
+  fprintf(file, "constexpr TrajectorySample %sSamples[] = {\n", config.name.c_str());
+  fprintf(file, "  //x, y, heading, velocity, curvature, time\n");
+
+  for (size_t i=0; i<samples.size(); i++) {
+    const Sample &s = samples[i];
+    fprintf(file, "  { %.3ff, %.3ff, %.5ff, %.3ff, %.5ff, %.4ff },\n", s.x, s.y, s.heading, s.velocity, s.curvature, s.time);
+  }
+
+  fprintf(file, "};\n\n");
+  fprintf(file, "constexpr Trajectory %s = { %sSamples, %lu, %.3ff };\n\n", config.name.c_str(), config.name.c_str(), (unsigned long)samples.size(), config.spacing);
+  fprintf(file, "#endif\n");
+  fclose(file);
+
+  return true;
+}
+//#endregion
+
+int main(int argc, char *argv[]) {
+  if (argc != 3) {
+    printf("Usage: %s <input.path> <output.h>\n", argv[0]);
+    return 1;
+  }
+
+  PathConfig config = { "", 0, 0, 0, 1, {} };
+
+  //default name is input file name without directory or extension
+  const char *base = strrchr(argv[1], '/');
+  config.name = (base ? base+1 : argv[1]);
+  config.name = config.name.substr(0, config.name.find('.'));
+
+  if (!readPath(argv[1], config)) return 1;
+
+  std::vector<Sample> samples = sampleSpline(config);
+  profileVelocity(config, samples);
+
+  if (!writeHeader(argv[2], config, samples)) return 1;
+
+  printf("%s: %lu samples, %.2f s\n", argv[2], (unsigned long)samples.size(), samples.back().time);
+  return 0;
+}